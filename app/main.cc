@@ -1,3 +1,4 @@
+#include <reading.hh>
 #include <solving.hh>
 
 #ifdef CLINGOLPX_PROFILE
@@ -5,7 +6,11 @@
 #endif
 
 #include <clingo.hh>
-#include <sstream>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <tuple>
 #include <variant>
 
 #ifdef CLINGOLPX_PROFILE
@@ -27,6 +32,43 @@ constexpr bool is_mono() {
     return std::is_same_v<std::decay_t<T>, std::monostate>;
 }
 
+//! The values of the variables in a model.
+//!
+//! The entries are kept between models so that the storage of their values
+//! is reused.
+template <class V>
+class ModelValues {
+public:
+    //! Remove all values.
+    void clear() {
+        size_ = 0;
+    }
+
+    //! Add the value of a variable.
+    void add(Clingo::Symbol var, V const &val) {
+        if (size_ < values_.size()) {
+            values_[size_].first = var;
+            values_[size_].second = val;
+        }
+        else {
+            values_.emplace_back(var, val);
+        }
+        ++size_;
+    }
+
+    //! Call `f(var, value)` for each value.
+    template <class F>
+    void for_each(F &&f) const {
+        for (size_t i = 0; i < size_; ++i) {
+            f(values_[i].first, values_[i].second);
+        }
+    }
+
+private:
+    std::vector<std::pair<Clingo::Symbol, V>> values_;
+    size_t size_{0};
+};
+
 class Application : public Clingo::Application, public Clingo::SolveEventHandler {
 public:
     Application() = default;
@@ -44,31 +86,46 @@ public:
         return "1.0.0";
     }
 
-    void print_model(Clingo::Model const &model, std::function<void()> default_printer) noexcept override {
-        default_printer();
-        std::cout << last_assignment_.str() << std::endl;
-    }
-
     bool on_model(Clingo::Model &model) override {
-        last_assignment_.str("");
-        last_assignment_ << "Assignment:\n";
-        bool comma = false;
+        std::get<0>(values_).clear();
+        std::get<1>(values_).clear();
         std::visit([&](auto &&prp) {
             if constexpr (!is_mono<decltype(prp)>()) {
-                for (auto const &[var, val] : prp.assignment(model.thread_id())) {
-                    if (comma) {
-                        last_assignment_ << " ";
-                    }
-                    else {
-                        comma = true;
-                    }
-                    last_assignment_ << var << "=" << val;
+                prp.extend_model(model);
+                // Note: the values are copied because clingo might print the
+                // model after the solver moved on. They are only formatted in
+                // print_model, which is only called if models are printed.
+                if (!options_.show_values) {
+                    prp.assignment(model.thread_id(), [this](Clingo::Symbol var, auto const &val) {
+                        std::get<ModelValues<std::decay_t<decltype(val)>>>(values_).add(var, val);
+                    });
                 }
             }
         }, prp_);
         return true;
     }
 
+    void print_model(Clingo::Model const &, std::function<void()> default_printer) noexcept override {
+        default_printer();
+        if (options_.show_values) {
+            return;
+        }
+        std::cout << "Assignment:\n";
+        bool comma = false;
+        auto print = [&](Clingo::Symbol var, auto const &val) {
+            if (comma) {
+                std::cout << " ";
+            }
+            else {
+                comma = true;
+            }
+            std::cout << var << "=" << val;
+        };
+        std::get<0>(values_).for_each(print);
+        std::get<1>(values_).for_each(print);
+        std::cout << std::endl;
+    }
+
     void on_statistics(Clingo::UserStatistics step, Clingo::UserStatistics accu) override {
         std::visit([&](auto &&prp) {
             if constexpr (!is_mono<decltype(prp)>()) {
@@ -79,14 +136,83 @@ public:
 
     void register_options(Clingo::ClingoOptions &opts) override {
         opts.add_flag("Clingo.LPX", "strict", "Enable support for strict constraints", strict_);
+        opts.add("Clingo.LPX", "show-values", "Add facts lpx(Var,Value) to models instead of printing the assignment\n"
+                 "      <sigs>: all or comma-separated signatures <name>/<arity> of variables to show", [this](char const *value) {
+            return parse_show_values(value, options_);
+        }, true, "<sigs>");
+        opts.add("Clingo.LPX", "decompose", "Solve independent components of the problem separately [yes]", [this](char const *value) {
+            return parse_bool(value, options_.decompose);
+        }, false, "{yes,no}");
+        opts.add("Clingo.LPX", "difference-logic", "Handle rows of form x - y <= k with a difference logic engine [yes]", [this](char const *value) {
+            return parse_bool(value, options_.difference_logic);
+        }, false, "{yes,no}");
+        opts.add("Clingo.LPX", "simplify", "Remove fixed variables and dead rows on the top level [yes]", [this](char const *value) {
+            return parse_bool(value, options_.simplify);
+        }, false, "{yes,no}");
+        opts.add("Clingo.LPX", "reorder", "Order rows and variables to reduce the bandwidth of the tableau [yes]", [this](char const *value) {
+            return parse_bool(value, options_.reorder);
+        }, false, "{yes,no}");
+        opts.add("Clingo.LPX", "parse-threads", "Evaluate theory atoms using <n> threads [1] [0=hardware threads]", [this](char const *value) {
+            return parse_num(value, options_.parse_threads);
+        }, false, "<n>");
+        opts.add("Clingo.LPX", "propagate-threads", "Solve independent components using <n> threads [1] [0=hardware threads]", [this](char const *value) {
+            return parse_num(value, options_.propagate_threads);
+        }, false, "<n>");
+        opts.add("Clingo.LPX", "read-lp", "Read linear constraints from the given LP file", [this](char const *value) {
+            inputs_.emplace_back(false, value);
+            return true;
+        }, true, "<file>");
+        opts.add("Clingo.LPX", "read-mps", "Read linear constraints from the given free MPS file", [this](char const *value) {
+            inputs_.emplace_back(true, value);
+            return true;
+        }, true, "<file>");
+        opts.add("Clingo.LPX", "lp-guard", "Guard rows of LP/MPS files by atoms <name>(\"row\") instead of facts", [this](char const *value) {
+            guard_ = value;
+            return !guard_.empty();
+        }, false, "<name>");
+        opts.add("Clingo.LPX", "write-lp", "Write the prepared problem to the given LP file", [this](char const *value) {
+            write_lp_ = value;
+            return !write_lp_.empty();
+        }, false, "<file>");
+        opts.add("Clingo.LPX", "write-mps", "Write the prepared problem to the given free MPS file", [this](char const *value) {
+            write_mps_ = value;
+            return !write_mps_.empty();
+        }, false, "<file>");
+        opts.add("Clingo.LPX", "write-basis", "Write the final basis of the first thread to the given file", [this](char const *value) {
+            write_basis_ = value;
+            return !write_basis_.empty();
+        }, false, "<file>");
+        opts.add("Clingo.LPX", "load-basis", "Start from the basis in the given file written with --write-basis", [this](char const *value) {
+            options_.load_basis = value;
+            return !options_.load_basis.empty();
+        }, false, "<file>");
+        opts.add("Clingo.LPX", "save-snapshot", "Write the prepared state to the given snapshot file", [this](char const *value) {
+            options_.save_snapshot = value;
+            return !options_.save_snapshot.empty();
+        }, false, "<file>");
+        opts.add("Clingo.LPX", "load-snapshot", "Load the prepared state from the given snapshot file", [this](char const *value) {
+            options_.load_snapshot = value;
+            return !options_.load_snapshot.empty();
+        }, false, "<file>");
+#ifdef CLINGOLPX_TRACE
+        opts.add("Clingo.LPX", "trace-file", "Write solver events to the given Chrome trace file [trace.json]", [this](char const *value) {
+            trace_file_ = value;
+            return !trace_file_.empty();
+        }, false, "<file>");
+#endif
     }
 
     void main(Clingo::Control &ctl, Clingo::StringSpan files) override {
+        // exported problems have to contain all rows in a single tableau
+        if (!write_lp_.empty() || !write_mps_.empty() || !write_basis_.empty()) {
+            options_.decompose = false;
+            options_.difference_logic = false;
+        }
         if (strict_) {
-            prp_ = Propagator<Number, NumberQ>{};
+            prp_.emplace<Propagator<Number, NumberQ>>(options_);
         }
         else {
-            prp_ = Propagator<Number, Number>{};
+            prp_.emplace<Propagator<Number, Number>>(options_);
         }
         std::visit([&ctl](auto &&prp) {
             if constexpr (!is_mono<decltype(prp)>()) {
@@ -97,15 +223,115 @@ public:
             ctl.load(x);
         }
         ctl.ground({{"base", {}}});
+        read_inputs_(ctl);
 #ifdef CLINGOLPX_PROFILE
         Profiler prof("profile.out");
 #endif
         ctl.solve(Clingo::LiteralSpan{}, this, false, false).get();
+        write_outputs_();
+#ifdef CLINGOLPX_TRACE
+        std::ofstream out{trace_file_};
+        std::visit([&out](auto &&prp) {
+            if constexpr (!is_mono<decltype(prp)>()) {
+                prp.write_trace(out);
+            }
+        }, prp_);
+#endif
     }
 
 private:
-    std::stringstream last_assignment_;
+    //! Read the LP and MPS files passed via options.
+    //!
+    //! Rows are guarded by a fact or, if option `--lp-guard` is given, by
+    //! atoms mapping to the names of the rows. Bounds of variables are
+    //! always guarded by a fact.
+    void read_inputs_(Clingo::Control &ctl) {
+        if (inputs_.empty()) {
+            return;
+        }
+        ctl.with_backend([&](Clingo::Backend &backend) {
+            Clingo::atom_t fact = 0;
+            Guard guard = [&](char const *name) {
+                if (name != nullptr && !guard_.empty()) {
+                    return static_cast<Clingo::literal_t>(backend.add_atom(Clingo::Function(guard_.c_str(), {Clingo::String(name)})));
+                }
+                if (fact == 0) {
+                    fact = backend.add_atom();
+                    backend.rule(false, {fact}, {});
+                }
+                return static_cast<Clingo::literal_t>(fact);
+            };
+            for (auto const &[mps, file] : inputs_) {
+                std::ifstream in{file};
+                if (!in) {
+                    throw std::runtime_error("could not open file: " + file);
+                }
+                auto problem = mps ? read_mps(in, guard) : read_lp(in, guard);
+                std::visit([&problem](auto &&prp) {
+                    if constexpr (!is_mono<decltype(prp)>()) {
+                        prp.add_problem(problem);
+                    }
+                }, prp_);
+            }
+        });
+    }
+
+    //! Write the prepared problem and basis to the files passed via options.
+    void write_outputs_() {
+        auto write = [this](std::string const &file, auto &&f) {
+            if (file.empty()) {
+                return;
+            }
+            std::ofstream out{file};
+            if (!out) {
+                throw std::runtime_error("could not open file: " + file);
+            }
+            std::visit([&](auto &&prp) {
+                if constexpr (!is_mono<decltype(prp)>()) {
+                    f(prp, out);
+                }
+            }, prp_);
+        };
+        write(write_lp_, [](auto &prp, std::ostream &out) { prp.write_problem(out, false); });
+        write(write_mps_, [](auto &prp, std::ostream &out) { prp.write_problem(out, true); });
+        write(write_basis_, [](auto &prp, std::ostream &out) { prp.write_basis(out); });
+    }
+
+    [[nodiscard]] static bool parse_num(char const *value, size_t &res) {
+        char *end = nullptr;
+        errno = 0;
+        auto num = std::strtoull(value, &end, 10);
+        if (errno != 0 || end == value || *end != '\0') {
+            return false;
+        }
+        res = num;
+        return true;
+    }
+
+    [[nodiscard]] static bool parse_bool(char const *value, bool &res) {
+        if (std::strcmp(value, "yes") == 0) {
+            res = true;
+            return true;
+        }
+        if (std::strcmp(value, "no") == 0) {
+            res = false;
+            return true;
+        }
+        return false;
+    }
+
+#ifdef CLINGOLPX_TRACE
+    std::string trace_file_{"trace.json"};
+#endif
+    std::vector<std::pair<bool, std::string>> inputs_;
+    std::string guard_;
+    std::string write_lp_;
+    std::string write_mps_;
+    std::string write_basis_;
     std::variant<std::monostate, Propagator<Number, Number>, Propagator<Number, NumberQ>> prp_;
+    //! The values of the last model.
+    std::tuple<ModelValues<Number>, ModelValues<NumberQ>> values_;
+    Options options_;
     bool strict_{false};
 };
 
@@ -0,0 +1,352 @@
+#include <clingo-lpx.h>
+#include <solving.hh>
+
+#include <clingo.hh>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+[[nodiscard]] bool parse_num(char const *value, size_t &res) {
+    char *end = nullptr;
+    errno = 0;
+    auto num = std::strtoull(value, &end, 10);
+    if (errno != 0 || end == value || *end != '\0') {
+        return false;
+    }
+    res = num;
+    return true;
+}
+
+[[nodiscard]] bool parse_bool(char const *value, bool &res) {
+    if (std::strcmp(value, "true") == 0 || std::strcmp(value, "yes") == 0 || std::strcmp(value, "1") == 0) {
+        res = true;
+        return true;
+    }
+    if (std::strcmp(value, "false") == 0 || std::strcmp(value, "no") == 0 || std::strcmp(value, "0") == 0) {
+        res = false;
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+void to_symbol(T const &x, clingolpx_value_t *value) {
+    std::ostringstream oss;
+    oss << x;
+    value->type = clingolpx_value_type_symbol;
+    value->symbol = Clingo::String(oss.str().c_str()).to_c();
+}
+
+void to_value(Number const &x, clingolpx_value_t *value) {
+    if (x.get_den() == 1 && mpz_fits_sint_p(x.get_num_mpz_t()) != 0) {
+        value->type = clingolpx_value_type_int;
+        value->int_number = static_cast<int>(mpz_get_si(x.get_num_mpz_t()));
+    }
+    else {
+        to_symbol(x, value);
+    }
+}
+
+void to_value(NumberQ const &x, clingolpx_value_t *value) {
+    if (x.k() == 0) {
+        to_value(x.c(), value);
+    }
+    else {
+        to_symbol(x, value);
+    }
+}
+
+//! Interface to the propagator independent of the type of values.
+class TheoryBase {
+public:
+    TheoryBase() = default;
+    TheoryBase(TheoryBase const &) = delete;
+    TheoryBase(TheoryBase &&) = delete;
+    TheoryBase &operator=(TheoryBase const &) = delete;
+    TheoryBase &operator=(TheoryBase &&) = delete;
+    virtual ~TheoryBase() = default;
+
+    virtual void register_control(Clingo::Control &ctl) = 0;
+    virtual void on_model(Clingo::Model &model) = 0;
+    virtual void on_statistics(Clingo::UserStatistics step, Clingo::UserStatistics accu) = 0;
+    [[nodiscard]] virtual bool lookup_symbol(Clingo::Symbol sym, size_t &index) const = 0;
+    [[nodiscard]] virtual Clingo::Symbol get_symbol(size_t index) const = 0;
+    [[nodiscard]] virtual bool has_value(uint32_t thread_id, size_t index) const = 0;
+    virtual void get_value(uint32_t thread_id, size_t index, clingolpx_value_t *value) const = 0;
+};
+
+template <typename Value>
+class Theory final : public TheoryBase {
+public:
+    explicit Theory(Options const &options)
+    : prp_{options} { }
+
+    void register_control(Clingo::Control &ctl) override {
+        prp_.register_control(ctl);
+    }
+
+    void on_model(Clingo::Model &model) override {
+        prp_.extend_model(model);
+        // the variables only change when the propagator is initialized for a
+        // new solve call and the values of previous calls refer to the old
+        // variables
+        auto generation = prp_.generation();
+        if (generation_ != generation) {
+            generation_ = generation;
+            values_.clear();
+            symbols_.clear();
+            prp_.assignment(model.thread_id(), [this](Clingo::Symbol var, Value const &val) {
+                static_cast<void>(val);
+                symbols_.emplace_back(var);
+            });
+        }
+        auto thread_id = model.thread_id();
+        if (values_.size() <= thread_id) {
+            values_.resize(thread_id + 1);
+        }
+        auto &values = values_[thread_id];
+        values.clear();
+        prp_.assignment(thread_id, [&values](Clingo::Symbol var, Value const &val) {
+            static_cast<void>(var);
+            values.emplace_back(val);
+        });
+    }
+
+    void on_statistics(Clingo::UserStatistics step, Clingo::UserStatistics accu) override {
+        prp_.on_statistics(step, accu);
+    }
+
+    [[nodiscard]] bool lookup_symbol(Clingo::Symbol sym, size_t &index) const override {
+        auto it = std::lower_bound(symbols_.begin(), symbols_.end(), sym);
+        if (it == symbols_.end() || *it != sym) {
+            return false;
+        }
+        index = it - symbols_.begin() + 1;
+        return true;
+    }
+
+    [[nodiscard]] Clingo::Symbol get_symbol(size_t index) const override {
+        return symbols_[index - 1];
+    }
+
+    [[nodiscard]] bool has_value(uint32_t thread_id, size_t index) const override {
+        return thread_id < values_.size() && index > 0 && index <= values_[thread_id].size();
+    }
+
+    void get_value(uint32_t thread_id, size_t index, clingolpx_value_t *value) const override {
+        to_value(values_[thread_id][index - 1], value);
+    }
+
+private:
+    Propagator<Number, Value> prp_;
+    //! The sorted variables of the last model.
+    std::vector<Clingo::Symbol> symbols_;
+    //! The values of the last model per thread.
+    std::vector<std::vector<Value>> values_;
+    //! The generation of the propagator `symbols_` and `values_` belong to.
+    size_t generation_{0};
+};
+
+} // namespace
+
+struct clingolpx_theory {
+    std::unique_ptr<TheoryBase> theory;
+    Options options;
+    bool strict{false};
+    //! The data passed to the parse callbacks of options.
+    std::deque<std::pair<clingolpx_theory *, char const *>> option_data;
+};
+
+namespace {
+
+[[nodiscard]] bool configure(clingolpx_theory &theory, char const *key, char const *value) {
+    if (theory.theory) {
+        throw std::runtime_error("the theory must be configured before registering it");
+    }
+    if (std::strcmp(key, "strict") == 0) {
+        return parse_bool(value, theory.strict);
+    }
+    if (std::strcmp(key, "decompose") == 0) {
+        return parse_bool(value, theory.options.decompose);
+    }
+    if (std::strcmp(key, "difference-logic") == 0) {
+        return parse_bool(value, theory.options.difference_logic);
+    }
+    if (std::strcmp(key, "simplify") == 0) {
+        return parse_bool(value, theory.options.simplify);
+    }
+    if (std::strcmp(key, "reorder") == 0) {
+        return parse_bool(value, theory.options.reorder);
+    }
+    if (std::strcmp(key, "parse-threads") == 0) {
+        return parse_num(value, theory.options.parse_threads);
+    }
+    if (std::strcmp(key, "propagate-threads") == 0) {
+        return parse_num(value, theory.options.propagate_threads);
+    }
+    if (std::strcmp(key, "show-values") == 0) {
+        return parse_show_values(value, theory.options);
+    }
+    if (std::strcmp(key, "load-basis") == 0) {
+        theory.options.load_basis = value;
+        return !theory.options.load_basis.empty();
+    }
+    if (std::strcmp(key, "save-snapshot") == 0) {
+        theory.options.save_snapshot = value;
+        return !theory.options.save_snapshot.empty();
+    }
+    if (std::strcmp(key, "load-snapshot") == 0) {
+        theory.options.load_snapshot = value;
+        return !theory.options.load_snapshot.empty();
+    }
+    return false;
+}
+
+[[nodiscard]] bool parse_option(char const *value, void *data) {
+    auto &[theory, key] = *static_cast<std::pair<clingolpx_theory *, char const *> *>(data);
+    try {
+        return configure(*theory, key, value);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+[[nodiscard]] TheoryBase &get_theory(clingolpx_theory_t *theory) {
+    if (!theory->theory) {
+        throw std::runtime_error("the theory has not been registered");
+    }
+    return *theory->theory;
+}
+
+} // namespace
+
+extern "C" void clingolpx_version(int *major, int *minor, int *patch) {
+    if (major != nullptr) {
+        *major = CLINGOLPX_VERSION_MAJOR;
+    }
+    if (minor != nullptr) {
+        *minor = CLINGOLPX_VERSION_MINOR;
+    }
+    if (patch != nullptr) {
+        *patch = CLINGOLPX_VERSION_REVISION;
+    }
+}
+
+extern "C" bool clingolpx_create(clingolpx_theory_t **theory) {
+    CLINGO_TRY {
+        *theory = new clingolpx_theory{}; // NOLINT
+    }
+    CLINGO_CATCH;
+}
+
+extern "C" bool clingolpx_register(clingolpx_theory_t *theory, clingo_control_t* control) {
+    CLINGO_TRY {
+        if (theory->theory) {
+            throw std::runtime_error("the theory has already been registered");
+        }
+        if (theory->strict) {
+            theory->theory = std::make_unique<Theory<NumberQ>>(theory->options);
+        }
+        else {
+            theory->theory = std::make_unique<Theory<Number>>(theory->options);
+        }
+        Clingo::Control ctl{control, false};
+        theory->theory->register_control(ctl);
+    }
+    CLINGO_CATCH;
+}
+
+extern "C" bool clingolpx_destroy(clingolpx_theory_t *theory) {
+    CLINGO_TRY {
+        delete theory; // NOLINT
+    }
+    CLINGO_CATCH;
+}
+
+extern "C" bool clingolpx_configure(clingolpx_theory_t *theory, char const *key, char const *value) {
+    CLINGO_TRY {
+        if (!configure(*theory, key, value)) {
+            throw std::invalid_argument(std::string{"invalid configuration: "} + key + "=" + value);
+        }
+    }
+    CLINGO_CATCH;
+}
+
+extern "C" bool clingolpx_register_options(clingolpx_theory_t *theory, clingo_options_t* options) {
+    CLINGO_TRY {
+        char const *group = "Clingo.LPX";
+        auto add = [&](char const *key, char const *description, char const *argument) {
+            auto &data = theory->option_data.emplace_back(theory, key);
+            Clingo::Detail::handle_error(clingo_options_add(options, group, key, description, parse_option, &data, false, argument));
+        };
+        Clingo::Detail::handle_error(clingo_options_add_flag(options, group, "strict", "Enable support for strict constraints", &theory->strict));
+        add("decompose", "Solve independent components of the problem separately [yes]", "{yes,no}");
+        add("difference-logic", "Handle rows of form x - y <= k with a difference logic engine [yes]", "{yes,no}");
+        add("simplify", "Remove fixed variables and dead rows on the top level [yes]", "{yes,no}");
+        add("reorder", "Order rows and variables to reduce the bandwidth of the tableau [yes]", "{yes,no}");
+        add("parse-threads", "Evaluate theory atoms using <n> threads [1] [0=hardware threads]", "<n>");
+        add("propagate-threads", "Solve independent components using <n> threads [1] [0=hardware threads]", "<n>");
+        add("show-values", "Add facts lpx(Var,Value) for variables matching <sigs> to models [all]", "<sigs>");
+        add("load-basis", "Start from the basis in the given file written with --write-basis", "<file>");
+        add("save-snapshot", "Write the prepared state to the given snapshot file", "<file>");
+        add("load-snapshot", "Load the prepared state from the given snapshot file", "<file>");
+    }
+    CLINGO_CATCH;
+}
+
+extern "C" bool clingolpx_validate_options(clingolpx_theory_t *theory) {
+    static_cast<void>(theory);
+    return true;
+}
+
+extern "C" bool clingolpx_on_model(clingolpx_theory_t *theory, clingo_model_t* model) {
+    CLINGO_TRY {
+        Clingo::Model m{model};
+        get_theory(theory).on_model(m);
+    }
+    CLINGO_CATCH;
+}
+
+extern "C" bool clingolpx_lookup_symbol(clingolpx_theory_t *theory, clingo_symbol_t symbol, size_t *index) {
+    return theory->theory && theory->theory->lookup_symbol(Clingo::Symbol{symbol}, *index);
+}
+
+extern "C" clingo_symbol_t clingolpx_get_symbol(clingolpx_theory_t *theory, size_t index) {
+    return theory->theory->get_symbol(index).to_c();
+}
+
+extern "C" void clingolpx_assignment_begin(clingolpx_theory_t *theory, uint32_t thread_id, size_t *index) {
+    static_cast<void>(theory);
+    static_cast<void>(thread_id);
+    *index = 0;
+}
+
+extern "C" bool clingolpx_assignment_next(clingolpx_theory_t *theory, uint32_t thread_id, size_t *index) {
+    ++*index;
+    return clingolpx_assignment_has_value(theory, thread_id, *index);
+}
+
+extern "C" bool clingolpx_assignment_has_value(clingolpx_theory_t *theory, uint32_t thread_id, size_t index) {
+    return theory->theory && theory->theory->has_value(thread_id, index);
+}
+
+extern "C" void clingolpx_assignment_get_value(clingolpx_theory_t *theory, uint32_t thread_id, size_t index, clingolpx_value_t *value) {
+    theory->theory->get_value(thread_id, index, value);
+}
+
+extern "C" bool clingolpx_on_statistics(clingolpx_theory_t *theory, clingo_statistics_t* step, clingo_statistics_t* accu) {
+    CLINGO_TRY {
+        uint64_t root_s{0};
+        uint64_t root_a{0};
+        Clingo::Detail::handle_error(clingo_statistics_root(step, &root_s));
+        Clingo::Detail::handle_error(clingo_statistics_root(accu, &root_a));
+        get_theory(theory).on_statistics(Clingo::UserStatistics{step, root_s}, Clingo::UserStatistics{accu, root_a});
+    }
+    CLINGO_CATCH;
+}
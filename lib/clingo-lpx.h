@@ -0,0 +1,133 @@
+#ifndef CLINGOLPX_H
+#define CLINGOLPX_H
+
+//! Major version number.
+#define CLINGOLPX_VERSION_MAJOR 1
+//! Minor version number.
+#define CLINGOLPX_VERSION_MINOR 0
+//! Revision number.
+#define CLINGOLPX_VERSION_REVISION 0
+//! String representation of version.
+#define CLINGOLPX_VERSION "1.0.0"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined _WIN32 || defined __CYGWIN__
+#   define CLINGOLPX_WIN
+#endif
+#ifdef CLINGOLPX_NO_VISIBILITY
+#   define CLINGOLPX_VISIBILITY_DEFAULT
+#   define CLINGOLPX_VISIBILITY_PRIVATE
+#else
+#   ifdef CLINGOLPX_WIN
+#       ifdef CLINGOLPX_BUILD_LIBRARY
+#           define CLINGOLPX_VISIBILITY_DEFAULT __declspec (dllexport)
+#       else
+#           define CLINGOLPX_VISIBILITY_DEFAULT __declspec (dllimport)
+#       endif
+#       define CLINGOLPX_VISIBILITY_PRIVATE
+#   else
+#       if __GNUC__ >= 4
+#           define CLINGOLPX_VISIBILITY_DEFAULT  __attribute__ ((visibility ("default")))
+#           define CLINGOLPX_VISIBILITY_PRIVATE __attribute__ ((visibility ("hidden")))
+#       else
+#           define CLINGOLPX_VISIBILITY_DEFAULT
+#           define CLINGOLPX_VISIBILITY_PRIVATE
+#       endif
+#   endif
+#endif
+
+#include <clingo.h>
+
+//! Enumeration of value types.
+enum clingolpx_value_type_e {
+    //! An integral value fitting into an int.
+    clingolpx_value_type_int = 0,
+    //! Any other value represented as a string symbol.
+    clingolpx_value_type_symbol = 1
+};
+//! Corresponding type to ::clingolpx_value_type_e.
+typedef int clingolpx_value_type_t;
+
+//! Struct to store values of variables.
+typedef struct clingolpx_value {
+    clingolpx_value_type_t type;
+    union {
+        int int_number;
+        clingo_symbol_t symbol;
+    };
+} clingolpx_value_t;
+
+//! Handle for the theory.
+typedef struct clingolpx_theory clingolpx_theory_t;
+
+//! Obtain the version of the library.
+CLINGOLPX_VISIBILITY_DEFAULT void clingolpx_version(int *major, int *minor, int *patch);
+
+//! Creates the theory.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_create(clingolpx_theory_t **theory);
+
+//! Register the theory with a control object.
+//!
+//! Options have to be configured before calling this function.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_register(clingolpx_theory_t *theory, clingo_control_t* control);
+
+//! Destroy the theory.
+//!
+//! Currently no way to unregister a theory.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_destroy(clingolpx_theory_t *theory);
+
+//! Configure theory manually (without using clingo's options facility).
+//!
+//! Note that the theory has to be configured before registering it and cannot
+//! be reconfigured. Flags like `strict` expect values `true` or `false`.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_configure(clingolpx_theory_t *theory, char const *key, char const *value);
+
+//! Add options for the theory.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_register_options(clingolpx_theory_t *theory, clingo_options_t* options);
+
+//! Validate options for the theory.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_validate_options(clingolpx_theory_t *theory);
+
+//! Callback for models.
+//!
+//! The values of the model are copied and can be queried with the
+//! `clingolpx_assignment_*` functions until the next model of the same
+//! thread.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_on_model(clingolpx_theory_t *theory, clingo_model_t* model);
+
+//! Obtain the index of a symbol.
+//!
+//! Indices start at one and are only available after the first model. If
+//! the symbol does not occur in the theory, the function returns false.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_lookup_symbol(clingolpx_theory_t *theory, clingo_symbol_t symbol, size_t *index);
+
+//! Obtain the symbol at the given index.
+CLINGOLPX_VISIBILITY_DEFAULT clingo_symbol_t clingolpx_get_symbol(clingolpx_theory_t *theory, size_t index);
+
+//! Initialize index so that it can be used with clingolpx_assignment_next.
+CLINGOLPX_VISIBILITY_DEFAULT void clingolpx_assignment_begin(clingolpx_theory_t *theory, uint32_t thread_id, size_t *index);
+
+//! Move to the next index that has a value.
+//!
+//! Returns false if the end of the assignment has been reached.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_assignment_next(clingolpx_theory_t *theory, uint32_t thread_id, size_t *index);
+
+//! Check if the symbol at the given index has a value.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_assignment_has_value(clingolpx_theory_t *theory, uint32_t thread_id, size_t index);
+
+//! Get the value of the symbol at the given index.
+CLINGOLPX_VISIBILITY_DEFAULT void clingolpx_assignment_get_value(clingolpx_theory_t *theory, uint32_t thread_id, size_t index, clingolpx_value_t *value);
+
+//! Callback for statistic updates.
+//!
+//! Best add as statistics callback.
+CLINGOLPX_VISIBILITY_DEFAULT bool clingolpx_on_statistics(clingolpx_theory_t *theory, clingo_statistics_t* step, clingo_statistics_t* accu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
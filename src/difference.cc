@@ -0,0 +1,156 @@
+#include <difference.hh>
+
+#include <cassert>
+
+template <typename Value>
+DifferenceLogic<Value>::DifferenceLogic() {
+    nodes_.emplace_back();
+}
+
+template <typename Value>
+void DifferenceLogic<Value>::clear() {
+    nodes_.clear();
+    nodes_.emplace_back();
+    edges_.clear();
+    lit_edges_.clear();
+    trail_.clear();
+    reason_.clear();
+}
+
+template <typename Value>
+index_t DifferenceLogic<Value>::add_node() {
+    auto node = static_cast<index_t>(nodes_.size());
+    nodes_.emplace_back();
+    // new nodes are unconstrained and start with the value of the zero node
+    nodes_.back().value = nodes_.front().value;
+    return node;
+}
+
+template <typename Value>
+void DifferenceLogic<Value>::add_edge(Clingo::literal_t lit, index_t from, index_t to, Value weight) {
+    assert(from != to && from < nodes_.size() && to < nodes_.size());
+    lit_edges_.emplace(lit, static_cast<index_t>(edges_.size()));
+    edges_.emplace_back(Edge{from, to, std::move(weight), lit});
+}
+
+template <typename Value>
+bool DifferenceLogic<Value>::activate(Clingo::literal_t lit) {
+    for (auto it = lit_edges_.find(lit), ie = lit_edges_.end(); it != ie && it->first == lit; ++it) {
+        if (!activate_(it->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Value>
+void DifferenceLogic<Value>::backtrack(size_t size) {
+    // edges are removed in reverse order of their activation
+    for (; trail_.size() > size; trail_.pop_back()) {
+        auto &edge = edges_[trail_.back()];
+        nodes_[edge.from].out.pop_back();
+        edge.active = false;
+    }
+}
+
+template <typename Value>
+Value DifferenceLogic<Value>::value(index_t node) const {
+    Value ret = nodes_[node].value;
+    ret -= nodes_.front().value;
+    return ret;
+}
+
+template <typename Value>
+size_t DifferenceLogic<Value>::bytes() const {
+    size_t ret = nodes_.capacity() * sizeof(Node) + edges_.capacity() * sizeof(Edge);
+    for (auto const &node : nodes_) {
+        ret += node.out.capacity() * sizeof(index_t) + dynamic_bytes(node.value) + dynamic_bytes(node.gamma);
+    }
+    for (auto const &edge : edges_) {
+        ret += dynamic_bytes(edge.weight);
+    }
+    // Note: the size of hash table nodes is estimated because it depends on
+    // the standard library implementation.
+    ret += lit_edges_.bucket_count() * sizeof(void*) + lit_edges_.size() * (sizeof(typename decltype(lit_edges_)::value_type) + 2 * sizeof(void*));
+    ret += trail_.capacity() * sizeof(index_t);
+    return ret;
+}
+
+template <typename Value>
+bool DifferenceLogic<Value>::activate_(index_t e) {
+    auto &edge = edges_[e];
+    if (edge.active) {
+        return true;
+    }
+    auto &to = nodes_[edge.to];
+    Value gamma = nodes_[edge.from].value + edge.weight;
+    gamma -= to.value;
+    if (gamma < 0) {
+        to.gamma = std::move(gamma);
+        to.pred = e;
+        touched_.emplace_back(edge.to);
+        queue_.emplace(to.gamma, edge.to);
+    }
+    while (!queue_.empty()) {
+        auto s = queue_.top().second;
+        queue_.pop();
+        auto &ns = nodes_[s];
+        if (ns.done) {
+            continue;
+        }
+        ns.done = true;
+        changed_.emplace_back(s, ns.value);
+        ns.value += ns.gamma;
+        for (auto f : ns.out) {
+            auto const &edge_f = edges_[f];
+            auto &nt = nodes_[edge_f.to];
+            if (nt.done) {
+                continue;
+            }
+            Value gamma_t = ns.value + edge_f.weight;
+            gamma_t -= nt.value;
+            if (!(gamma_t < nt.gamma)) {
+                continue;
+            }
+            // the source of the new edge has to be decreased, too
+            if (edge_f.to == edge.from) {
+                reason_.clear();
+                reason_.emplace_back(edge.lit);
+                reason_.emplace_back(edge_f.lit);
+                for (auto x = s; x != edge.to; x = edges_[nodes_[x].pred].from) {
+                    reason_.emplace_back(edges_[nodes_[x].pred].lit);
+                }
+                for (auto it = changed_.rbegin(), ie = changed_.rend(); it != ie; ++it) {
+                    nodes_[it->first].value.swap(it->second);
+                }
+                reset_();
+                return false;
+            }
+            if (nt.gamma == 0) {
+                touched_.emplace_back(edge_f.to);
+            }
+            nt.gamma = std::move(gamma_t);
+            nt.pred = f;
+            queue_.emplace(nt.gamma, edge_f.to);
+        }
+    }
+    reset_();
+    nodes_[edge.from].out.emplace_back(e);
+    trail_.emplace_back(e);
+    edge.active = true;
+    return true;
+}
+
+template <typename Value>
+void DifferenceLogic<Value>::reset_() {
+    for (auto node : touched_) {
+        nodes_[node].gamma = Value{0};
+        nodes_[node].done = false;
+    }
+    touched_.clear();
+    changed_.clear();
+    queue_ = {};
+}
+
+template class DifferenceLogic<Number>;
+template class DifferenceLogic<NumberQ>;
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <util.hh>
+
+#include <clingo.hh>
+
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+//! An incremental solver for difference constraints.
+//!
+//! A constraint `x - y <= k` is represented as an edge from node `y` to node
+//! `x` with weight `k`. Edges are associated with literals and become active
+//! once their literals are assigned. Node zero has the fixed value zero and
+//! is used to express bounds.
+//!
+//! The solver maintains an assignment satisfying all active edges. When an
+//! edge is activated, the values of the nodes are relaxed along shortest
+//! paths and a conflict is detected if the edge closes a negative cycle
+//! (Cotton and Maler, 2006). Since removing edges keeps the assignment
+//! feasible, backtracking only has to deactivate edges.
+template <typename Value>
+class DifferenceLogic {
+public:
+    DifferenceLogic();
+
+    //! Remove all nodes and edges except for the zero node.
+    void clear();
+
+    //! Add a node and return its index.
+    [[nodiscard]] index_t add_node();
+
+    //! Add an edge enforcing `to - from <= weight` once the given literal is
+    //! true.
+    void add_edge(Clingo::literal_t lit, index_t from, index_t to, Value weight);
+
+    //! Activate the edges associated with the given literal.
+    //!
+    //! Returns false if an edge closes a negative cycle. The literals of the
+    //! edges in the cycle can then be obtained via `reason`.
+    [[nodiscard]] bool activate(Clingo::literal_t lit);
+
+    //! Return the number of active edges.
+    [[nodiscard]] size_t trail_size() const { return trail_.size(); }
+
+    //! Deactivate edges until the given number of edges is active.
+    void backtrack(size_t size);
+
+    //! Return the value of a node.
+    [[nodiscard]] Value value(index_t node) const;
+
+    //! Return the literals of the edges in the last negative cycle.
+    [[nodiscard]] std::vector<Clingo::literal_t> const &reason() const { return reason_; }
+
+    //! Return the number of edges.
+    [[nodiscard]] size_t num_edges() const { return edges_.size(); }
+
+    //! Estimate the number of bytes allocated by the engine.
+    [[nodiscard]] size_t bytes() const;
+
+private:
+    struct Edge {
+        index_t from;
+        index_t to;
+        Value weight;
+        Clingo::literal_t lit;
+        //! Whether the edge is on the trail.
+        bool active{false};
+    };
+    struct Node {
+        //! The value of the node, which is relative to the zero node.
+        Value value{0};
+        //! The pending decrease of the value while relaxing.
+        Value gamma{0};
+        //! The active outgoing edges.
+        std::vector<index_t> out;
+        //! The edge through which the decrease was propagated.
+        index_t pred{0};
+        //! Whether the value has been relaxed already.
+        bool done{false};
+    };
+    //! Compare queue entries such that the largest decrease comes first.
+    struct Compare {
+        bool operator()(std::pair<Value, index_t> const &a, std::pair<Value, index_t> const &b) const {
+            return b.first < a.first;
+        }
+    };
+
+    //! Activate a single edge unless it is active already.
+    [[nodiscard]] bool activate_(index_t e);
+    //! Reset the helper data used while relaxing.
+    void reset_();
+
+    //! The nodes.
+    std::vector<Node> nodes_;
+    //! The edges.
+    std::vector<Edge> edges_;
+    //! Mapping from literals to edges.
+    std::unordered_multimap<Clingo::literal_t, index_t> lit_edges_;
+    //! The active edges in the order of their activation.
+    std::vector<index_t> trail_;
+    //! The nodes with pending decreases ordered by their decrease.
+    std::priority_queue<std::pair<Value, index_t>, std::vector<std::pair<Value, index_t>>, Compare> queue_;
+    //! The nodes touched while relaxing.
+    std::vector<index_t> touched_;
+    //! The relaxed nodes together with their previous values.
+    std::vector<std::pair<index_t, Value>> changed_;
+    //! The literals of the edges in the last negative cycle.
+    std::vector<Clingo::literal_t> reason_;
+};
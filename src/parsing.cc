@@ -1,7 +1,11 @@
 #include <parsing.hh>
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
 #include <map>
-#include <regex>
+#include <thread>
+#include <unordered_map>
 
 namespace {
 
@@ -34,99 +38,142 @@ bool is_string(Clingo::TheoryTerm const &term) {
     return len >= 2 && name[0] == '"' && name[len - 1] == '"';
 }
 
-[[nodiscard]] Clingo::Symbol evaluate(Clingo::TheoryTerm const &term) {
-    if (is_string(term)) {
-        char const *name = term.name();
-        size_t len = std::strlen(term.name());
-        return Clingo::String(std::string{name + 1, name + len - 1}.c_str());
+//! Parse a decimal number of form `(-)?[0-9]+(\.[0-9]+)?`.
+[[nodiscard]] Number parse_decimal(char const *begin, char const *end) {
+    auto is_digit = [](char c) { return '0' <= c && c <= '9'; };
+    auto it = begin;
+    bool negative = it != end && *it == '-';
+    if (negative) {
+        ++it;
     }
-
-    if (term.type() == Clingo::TheoryTermType::Symbol) {
-        return Clingo::Function(term.name(), {});
+    auto ib = it;
+    for (; it != end && is_digit(*it); ++it) { }
+    check_syntax(it != ib);
+    std::string num{ib, it};
+    size_t scale = 0;
+    if (it != end && *it == '.') {
+        auto jb = ++it;
+        for (; it != end && is_digit(*it); ++it) { }
+        check_syntax(it != jb);
+        auto je = it;
+        for (; je != jb && *(je - 1) == '0'; --je) { }
+        num.append(jb, je);
+        scale = je - jb;
     }
-
-    if (term.type() == Clingo::TheoryTermType::Number) {
-        return Clingo::Number(term.number());
+    check_syntax(it == end);
+    mpz_class den;
+    mpz_ui_pow_ui(den.get_mpz_t(), 10, scale);
+    Number n{mpz_class{num, 10}, den};
+    n.canonicalize();
+    if (negative) {
+        n = -n;
     }
+    return n;
+}
 
-    if (match(term, "-", 1)) {
-        auto arg = evaluate(term.arguments().back());
-        if (arg.type() == Clingo::SymbolType::Number) {
-            return Clingo::Number(-arg.number());
-        }
-        if (arg.type() == Clingo::SymbolType::Function) {
-            return Clingo::Function(arg.name(), arg.arguments(), !arg.is_positive());
+//! Evaluates theory terms memoizing the results by term id.
+//!
+//! Clingo shares theory terms and thus each distinct term is evaluated only
+//! once.
+class Evaluator {
+public:
+    [[nodiscard]] Clingo::Symbol evaluate(Clingo::TheoryTerm const &term) {
+        auto it = symbols_.find(term.to_c());
+        if (it == symbols_.end()) {
+            it = symbols_.emplace(term.to_c(), evaluate_(term)).first;
         }
-        return throw_syntax_error<Clingo::Symbol>();
+        return it->second;
     }
 
-    check_syntax(!match(term, "..", 2) && !match(term, "*", 2) && !match(term, "/", 2));
+    [[nodiscard]] Clingo::Symbol evaluate_var(Clingo::TheoryTerm const &term) {
+        check_syntax(
+            !match(term, "-", 1) &&
+            !match(term, "..", 2) &&
+            !match(term, "*", 2) &&
+            !match(term, "/", 2));
+        check_syntax(
+            term.type() == Clingo::TheoryTermType::Tuple ||
+            term.type() == Clingo::TheoryTermType::Function ||
+            term.type() == Clingo::TheoryTermType::Symbol);
+
+        return evaluate(term);
+    }
 
-    if (term.type() == Clingo::TheoryTermType::Tuple || term.type() == Clingo::TheoryTermType::Function) {
-        std::vector<Clingo::Symbol> args;
-        args.reserve(term.arguments().size());
-        for (auto const &arg : term.arguments()) {
-            args.emplace_back(evaluate(arg));
+    [[nodiscard]] Number const &evaluate_num(Clingo::TheoryTerm const &term) {
+        auto it = numbers_.find(term.to_c());
+        if (it == numbers_.end()) {
+            it = numbers_.emplace(term.to_c(), evaluate_num_(term)).first;
         }
-        return Clingo::Function(term.type() == Clingo::TheoryTermType::Function ? term.name() : "", args);
+        return it->second;
     }
 
-    return throw_syntax_error<Clingo::Symbol>();
-}
+private:
+    [[nodiscard]] Clingo::Symbol evaluate_(Clingo::TheoryTerm const &term) {
+        if (is_string(term)) {
+            char const *name = term.name();
+            size_t len = std::strlen(term.name());
+            return Clingo::String(std::string{name + 1, name + len - 1}.c_str());
+        }
 
-[[nodiscard]] Clingo::Symbol evaluate_var(Clingo::TheoryTerm const &term) {
-    check_syntax(
-        !match(term, "-", 1) &&
-        !match(term, "..", 2) &&
-        !match(term, "*", 2) &&
-        !match(term, "/", 2));
-    check_syntax(
-        term.type() == Clingo::TheoryTermType::Tuple ||
-        term.type() == Clingo::TheoryTermType::Function ||
-        term.type() == Clingo::TheoryTermType::Symbol);
-
-    return evaluate(term);
-}
+        if (term.type() == Clingo::TheoryTermType::Symbol) {
+            return Clingo::Function(term.name(), {});
+        }
 
-[[nodiscard]] Number evaluate_num(Clingo::TheoryTerm const &term) {
-    if (is_string(term)) {
-        auto const *name = term.name();
-        std::regex const rgx{"(-)?([0-9]+)(\\.([0-9]+))?"};
-        std::cmatch match;
-        check_syntax(std::regex_match(name + 1, name + strlen(name) - 1, match, rgx));
-        std::string a = match[2];
-        if (match[4].matched) {
-            auto const *ib = match[4].first;
-            auto const *it = match[4].second;
-            for (; it != ib && *(it - 1) == '0'; --it) { }
-            a.append(ib, it);
-            a.append("/1");
-            a.append(it - ib, '0');
+        if (term.type() == Clingo::TheoryTermType::Number) {
+            return Clingo::Number(term.number());
         }
-        Number n{a, 10};
-        if (match[1].matched) {
-            n *= -1;
+
+        if (match(term, "-", 1)) {
+            auto arg = evaluate(term.arguments().back());
+            if (arg.type() == Clingo::SymbolType::Number) {
+                return Clingo::Number(-arg.number());
+            }
+            if (arg.type() == Clingo::SymbolType::Function) {
+                return Clingo::Function(arg.name(), arg.arguments(), !arg.is_positive());
+            }
+            return throw_syntax_error<Clingo::Symbol>();
         }
-        n.canonicalize();
-        return n;
-    }
 
-    if (term.type() == Clingo::TheoryTermType::Number) {
-        return {term.number()};
-    }
+        check_syntax(!match(term, "..", 2) && !match(term, "*", 2) && !match(term, "/", 2));
 
-    if (match(term, "-", 1)) {
-        return -evaluate_num(term.arguments().front());
-    }
-    if (match(term, "*", 2)) {
-        return evaluate_num(term.arguments().front()) * evaluate_num(term.arguments().back());
+        if (term.type() == Clingo::TheoryTermType::Tuple || term.type() == Clingo::TheoryTermType::Function) {
+            std::vector<Clingo::Symbol> args;
+            args.reserve(term.arguments().size());
+            for (auto const &arg : term.arguments()) {
+                args.emplace_back(evaluate(arg));
+            }
+            return Clingo::Function(term.type() == Clingo::TheoryTermType::Function ? term.name() : "", args);
+        }
+
+        return throw_syntax_error<Clingo::Symbol>();
     }
-    if (match(term, "/", 2)) {
-        return evaluate_num(term.arguments().front()) / evaluate_num(term.arguments().back());
+
+    [[nodiscard]] Number evaluate_num_(Clingo::TheoryTerm const &term) {
+        if (is_string(term)) {
+            auto const *name = term.name();
+            return parse_decimal(name + 1, name + std::strlen(name) - 1);
+        }
+
+        if (term.type() == Clingo::TheoryTermType::Number) {
+            return {term.number()};
+        }
+
+        if (match(term, "-", 1)) {
+            return -evaluate_num(term.arguments().front());
+        }
+        if (match(term, "*", 2)) {
+            return evaluate_num(term.arguments().front()) * evaluate_num(term.arguments().back());
+        }
+        if (match(term, "/", 2)) {
+            return evaluate_num(term.arguments().front()) / evaluate_num(term.arguments().back());
+        }
+
+        return throw_syntax_error<Number>();
     }
 
-    return throw_syntax_error<Number>();
-}
+    std::unordered_map<Clingo::id_t, Clingo::Symbol> symbols_;
+    std::unordered_map<Clingo::id_t, Number> numbers_;
+};
 
 [[nodiscard]] Relation evaluate_cmp(char const *rel) {
     if (std::strcmp(rel, "<=") == 0) {
@@ -147,54 +194,128 @@ bool is_string(Clingo::TheoryTerm const &term) {
     return throw_syntax_error<Relation>();
 }
 
-} // namespace
+//! An inequality whose conditional terms still have to be replaced by
+//! auxiliary variables.
+struct PartialInequality {
+    Inequality iq;
+    //! The indices of conditional terms together with their condition ids.
+    std::vector<std::pair<size_t, Clingo::literal_t>> conditions;
+};
+
+//! The minimum number of theory atoms evaluated by a thread.
+constexpr size_t MIN_ATOMS_PER_THREAD = 1024;
 
-[[nodiscard]] std::vector<Inequality> evaluate_theory(Clingo::TheoryAtoms const &theory) {
-    std::vector<Inequality> iqs;
-    std::map<std::pair<Clingo::Symbol, Clingo::literal_t>, Clingo::Symbol> aux;
-    for (auto &&atom : theory) {
+void evaluate_atoms(Clingo::TheoryAtomIterator it, Clingo::TheoryAtomIterator ie, std::vector<PartialInequality> &piqs) {
+    Evaluator eval;
+    for (; it != ie; ++it) {
+        auto &&atom = *it;
         if (match(atom.term(), "dom", 0)) {
             check_syntax(atom.elements().size() == 1);
             auto &&elem = atom.elements().front();
             check_syntax(elem.tuple().size() == 1 && elem.condition().empty());
             auto &&term = elem.tuple().front();
             check_syntax(match(term, "..", 2));
-            auto var = evaluate_var(atom.guard().second);
-            iqs.emplace_back(Inequality{{{1, var}}, evaluate_num(term.arguments().back()), Relation::LessEqual, atom.literal()});
-            iqs.emplace_back(Inequality{{{1, var}}, evaluate_num(term.arguments().front()), Relation::GreaterEqual, atom.literal()});
+            auto var = eval.evaluate_var(atom.guard().second);
+            piqs.emplace_back(PartialInequality{Inequality{{{1, var}}, eval.evaluate_num(term.arguments().back()), Relation::LessEqual, atom.literal()}, {}});
+            piqs.emplace_back(PartialInequality{Inequality{{{1, var}}, eval.evaluate_num(term.arguments().front()), Relation::GreaterEqual, atom.literal()}, {}});
         }
         else if (match(atom.term(), "sum", 0)) {
             std::vector<Term> lhs;
+            std::vector<std::pair<size_t, Clingo::literal_t>> conditions;
             for (auto &&elem : atom.elements()) {
                 check_syntax(elem.tuple().size() == 1);
                 auto &&term = elem.tuple().front();
                 if (match(term, "-", 1)) {
                     lhs.emplace_back(Term{
                         -1,
-                        evaluate_var(term.arguments().back())});
+                        eval.evaluate_var(term.arguments().back())});
                 }
                 else if (match(term, "*", 2)) {
                     lhs.emplace_back(Term{
-                        evaluate_num(term.arguments().front()),
-                        evaluate_var(term.arguments().back())});
+                        eval.evaluate_num(term.arguments().front()),
+                        eval.evaluate_var(term.arguments().back())});
                 }
                 else {
-                    lhs.emplace_back(Term{1, evaluate_var(term)});
+                    lhs.emplace_back(Term{1, eval.evaluate_var(term)});
                 }
                 if (!elem.condition().empty()) {
-                    auto res = aux.try_emplace(std::make_pair(lhs.back().var, elem.condition_id()), Clingo::Number(aux.size()));
-                    if (res.second) {
-                        iqs.emplace_back(Inequality{{{1, res.first->second}}, 0, Relation::Equal, -elem.condition_id()});
-                        iqs.emplace_back(Inequality{{{1, res.first->second}, {-1, lhs.back().var}}, 0, Relation::Equal, elem.condition_id()});
-                    }
-                    lhs.back().var = res.first->second;
+                    conditions.emplace_back(lhs.size() - 1, elem.condition_id());
+                }
+            }
+            piqs.emplace_back(PartialInequality{Inequality{std::move(lhs),
+                                                           eval.evaluate_num(atom.guard().second),
+                                                           evaluate_cmp(atom.guard().first),
+                                                           atom.literal()},
+                                                std::move(conditions)});
+        }
+    }
+}
+
+} // namespace
+
+Problem evaluate_theory(Clingo::TheoryAtoms const &theory, size_t threads) {
+    AuxMap aux;
+    return evaluate_theory(theory, threads, 0, aux);
+}
+
+Problem evaluate_theory(Clingo::TheoryAtoms const &theory, size_t threads, size_t offset, AuxMap &aux) {
+    // partition the atoms into chunks evaluated in parallel
+    size_t n = theory.size() - std::min(offset, theory.size());
+    size_t m = std::max<size_t>(1, std::min(threads, n / MIN_ATOMS_PER_THREAD));
+    std::vector<std::vector<PartialInequality>> chunks(m);
+    auto chunk_begin = [&](size_t i) { return theory.begin() + static_cast<std::ptrdiff_t>(theory.size() - n + n * i / m); };
+    if (m == 1) {
+        evaluate_atoms(chunk_begin(0), theory.end(), chunks.front());
+    }
+    else {
+        std::vector<std::exception_ptr> errors(m);
+        std::vector<std::thread> workers;
+        workers.reserve(m);
+        for (size_t i = 0; i < m; ++i) {
+            workers.emplace_back([&, i]() {
+                try {
+                    evaluate_atoms(chunk_begin(i), chunk_begin(i + 1), chunks[i]);
                 }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        for (auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // merge the chunks in order interning variables and introducing
+    // auxiliary variables for conditional terms as if the atoms had been
+    // evaluated sequentially
+    Problem problem;
+    for (auto &chunk : chunks) {
+        for (auto &piq : chunk) {
+            for (auto const &[index, condition_id] : piq.conditions) {
+                auto &var = piq.iq.lhs[index].var;
+                auto res = aux.try_emplace(std::make_pair(var, condition_id), Clingo::Number(aux.size()));
+                if (res.second) {
+                    auto aux_var = problem.add_var(res.first->second);
+                    problem.add_term(1, aux_var);
+                    problem.add_row(0, Relation::Equal, -condition_id);
+                    problem.add_term(1, aux_var);
+                    problem.add_term(-1, problem.add_var(var));
+                    problem.add_row(0, Relation::Equal, condition_id);
+                }
+                var = res.first->second;
+            }
+            for (auto const &term : piq.iq.lhs) {
+                problem.add_term(term.co, problem.add_var(term.var));
             }
-            iqs.emplace_back(Inequality{std::move(lhs),
-                                        evaluate_num(atom.guard().second),
-                                        evaluate_cmp(atom.guard().first),
-                                        atom.literal()});
+            problem.add_row(piq.iq.rhs, piq.iq.rel, piq.iq.lit);
         }
+        chunk.clear();
     }
-    return iqs;
+    return problem;
 }
@@ -2,6 +2,8 @@
 
 #include <problem.hh>
 
+#include <map>
+
 constexpr char const *THEORY = R"(
 #theory lp {
     sum_term {
@@ -38,4 +40,18 @@ constexpr char const *THEORY_Q = R"(
 }.
 )";
 
-[[nodiscard]] std::vector<Inequality> evaluate_theory(Clingo::TheoryAtoms const &theory);
+//! Map from conditional terms to the auxiliary variables introduced for them.
+using AuxMap = std::map<std::pair<Clingo::Symbol, Clingo::literal_t>, Clingo::Symbol>;
+
+//! Evaluate the given theory atoms to a problem.
+//!
+//! For large theories, the atoms are evaluated by up to the given number of
+//! threads. The resulting problem does not depend on the number of threads.
+[[nodiscard]] Problem evaluate_theory(Clingo::TheoryAtoms const &theory, size_t threads = 1);
+
+//! Evaluate the theory atoms starting at the given offset.
+//!
+//! Auxiliary variables already contained in the given map are reused without
+//! adding their defining rows again. This makes it possible to evaluate only
+//! the atoms added in a step of multi-shot solving.
+[[nodiscard]] Problem evaluate_theory(Clingo::TheoryAtoms const &theory, size_t threads, size_t offset, AuxMap &aux);
@@ -0,0 +1,167 @@
+#include <perf.hh>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+[[nodiscard]] int open_counter(uint64_t config, int group_fd) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // measure the calling thread on any cpu
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+#endif
+
+//! The hardware counters of a thread.
+//!
+//! Counters only measure the thread that opened them, so each thread opens
+//! its own counters the first time they are read.
+class ThreadCounters {
+public:
+    using Values = PerfCounters::Values;
+    using Available = std::array<bool, perf_num_counters>;
+
+    ThreadCounters() = default;
+    ThreadCounters(ThreadCounters const &) = delete;
+    ThreadCounters(ThreadCounters &&) = delete;
+    ThreadCounters &operator=(ThreadCounters const &) = delete;
+    ThreadCounters &operator=(ThreadCounters &&) = delete;
+    ~ThreadCounters() {
+#ifdef __linux__
+        for (auto fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    //! Read the current counter values and mark the available counters.
+    bool read(Values &values, Available &available) {
+        if (!opened_) {
+            open_();
+        }
+#ifdef __linux__
+        // the values of the group are reported in the order the counters
+        // have been opened; the first available counter is the group leader
+        std::array<uint64_t, perf_num_counters + 1> buf{};
+        for (auto fd : fds_) {
+            if (fd >= 0) {
+                auto n = ::read(fd, buf.data(), sizeof(buf));
+                if (n < static_cast<ssize_t>(sizeof(uint64_t))) {
+                    return false;
+                }
+                size_t k = 1;
+                for (size_t i = 0; i < perf_num_counters; ++i) {
+                    values[i] = fds_[i] >= 0 && k <= buf[0] ? buf[k++] : 0;
+                    available[i] = available[i] || fds_[i] >= 0;
+                }
+                return true;
+            }
+        }
+#else
+        static_cast<void>(values);
+        static_cast<void>(available);
+#endif
+        return false;
+    }
+
+private:
+    void open_() {
+        opened_ = true;
+#ifdef __linux__
+        static constexpr std::array<uint64_t, perf_num_counters> configs{
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES};
+        int leader = -1;
+        for (size_t i = 0; i < perf_num_counters; ++i) {
+            fds_[i] = open_counter(configs[i], leader);
+            if (leader < 0) {
+                leader = fds_[i];
+            }
+        }
+#endif
+    }
+
+    std::array<int, perf_num_counters> fds_{-1, -1, -1, -1};
+    bool opened_{false};
+};
+
+//! Return the counters of the calling thread.
+ThreadCounters &thread_counters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+} // namespace
+
+char const *perf_name(PerfPhase phase) {
+    switch (phase) {
+        case PerfPhase::Solve: {
+            return "Solve";
+        }
+        case PerfPhase::Pivot: {
+            return "Pivot";
+        }
+        case PerfPhase::Eliminate: {
+            return "Eliminate";
+        }
+        case PerfPhase::Undo: {
+            break;
+        }
+    }
+    return "Undo";
+}
+
+char const *perf_name(PerfCounter counter) {
+    switch (counter) {
+        case PerfCounter::Cycles: {
+            return "Cycles";
+        }
+        case PerfCounter::Instructions: {
+            return "Instructions";
+        }
+        case PerfCounter::CacheMisses: {
+            return "Cache Misses";
+        }
+        case PerfCounter::BranchMisses: {
+            break;
+        }
+    }
+    return "Branch Misses";
+}
+
+bool PerfCounters::read(Values &values) {
+    return thread_counters().read(values, available_);
+}
+
+void PerfCounters::accumulate(PerfPhase phase, Values const &start) {
+    Values end;
+    if (read(end)) {
+        auto &values = values_[static_cast<size_t>(phase)];
+        for (size_t i = 0; i < perf_num_counters; ++i) {
+            values[i] += end[i] - start[i];
+        }
+        ++calls_[static_cast<size_t>(phase)];
+    }
+}
+
+void PerfCounters::reset() {
+    values_ = {};
+    calls_ = {};
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <util.hh>
+
+#include <array>
+
+#ifdef CLINGOLPX_PERF
+#   define perf_scope(P, PHASE) PerfScope perf_scope_guard_{P, PHASE}
+#else
+#   define perf_scope(P, PHASE)
+#endif
+
+//! The solver phases for which hardware counters are collected.
+enum class PerfPhase : uint32_t {
+    Solve = 0,
+    Pivot = 1,
+    Eliminate = 2,
+    Undo = 3,
+};
+
+//! The collected hardware counters.
+enum class PerfCounter : uint32_t {
+    Cycles = 0,
+    Instructions = 1,
+    CacheMisses = 2,
+    BranchMisses = 3,
+};
+
+constexpr size_t perf_num_phases = 4;
+constexpr size_t perf_num_counters = 4;
+
+//! Return the name of a phase.
+[[nodiscard]] char const *perf_name(PerfPhase phase);
+
+//! Return the name of a counter.
+[[nodiscard]] char const *perf_name(PerfCounter counter);
+
+//! Hardware performance counters accumulated per solver phase.
+//!
+//! The counters are read from counters of the calling thread, which are
+//! opened lazily via `perf_event_open` the first time a thread enters a
+//! phase. Since the start and end of a phase are read on the same thread,
+//! an instance can be used from different threads as long as it is not used
+//! concurrently. Counters that cannot be opened, for example, because the
+//! kernel does not permit it or the system is not Linux, are simply not
+//! reported.
+class PerfCounters {
+public:
+    using Values = std::array<uint64_t, perf_num_counters>;
+
+    //! Read the current counter values of the calling thread.
+    //!
+    //! Returns false if no counters are available.
+    bool read(Values &values);
+
+    //! Add the difference between the given counter values and the current
+    //! values of the calling thread to the given phase.
+    void accumulate(PerfPhase phase, Values const &start);
+
+    //! Check if the given counter is available.
+    [[nodiscard]] bool available(PerfCounter counter) const {
+        return available_[static_cast<size_t>(counter)];
+    }
+
+    //! Return the number of times the given phase has been entered.
+    [[nodiscard]] uint64_t calls(PerfPhase phase) const {
+        return calls_[static_cast<size_t>(phase)];
+    }
+
+    //! Return the accumulated value of a counter in a phase.
+    [[nodiscard]] uint64_t value(PerfPhase phase, PerfCounter counter) const {
+        return values_[static_cast<size_t>(phase)][static_cast<size_t>(counter)];
+    }
+
+    //! Reset the accumulated values.
+    void reset();
+
+private:
+    std::array<Values, perf_num_phases> values_{};
+    std::array<uint64_t, perf_num_phases> calls_{};
+    std::array<bool, perf_num_counters> available_{};
+};
+
+//! Accumulate hardware counters for a phase while the object is alive.
+class PerfScope {
+public:
+    PerfScope(PerfCounters &counters, PerfPhase phase)
+    : counters_{counters}
+    , phase_{phase}
+    , active_{counters_.read(start_)} { }
+    PerfScope(PerfScope const &) = delete;
+    PerfScope(PerfScope &&) = delete;
+    PerfScope &operator=(PerfScope const &) = delete;
+    PerfScope &operator=(PerfScope &&) = delete;
+    ~PerfScope() {
+        if (active_) {
+            counters_.accumulate(phase_, start_);
+        }
+    }
+
+private:
+    PerfCounters &counters_;
+    PerfCounters::Values start_{};
+    PerfPhase phase_;
+    bool active_;
+};
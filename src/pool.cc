@@ -0,0 +1,73 @@
+#include <pool.hh>
+
+WorkerPool::WorkerPool(size_t workers) {
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        threads_.emplace_back([this]() { work_(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(size_t n, std::function<void(size_t)> const &f) {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        job_ = &f;
+        n_ = n;
+        next_ = 0;
+        active_ = threads_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    start_.notify_all();
+    drain_(f, n);
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait(lock, [this]() { return active_ == 0; });
+    job_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void WorkerPool::drain_(std::function<void(size_t)> const &f, size_t n) {
+    for (size_t i = next_++; i < n; i = next_++) {
+        try {
+            f(i);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+void WorkerPool::work_() {
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        start_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+        if (stop_) {
+            return;
+        }
+        generation = generation_;
+        auto const *job = job_;
+        auto n = n_;
+        lock.unlock();
+        drain_(*job, n);
+        lock.lock();
+        if (--active_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
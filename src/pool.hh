@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! A pool of worker threads executing the iterations of loops.
+//!
+//! The threads are started once and wait for work in between loops, which
+//! keeps the overhead of a loop low enough to use the pool during
+//! propagation.
+class WorkerPool {
+public:
+    //! Start the given number of worker threads.
+    //!
+    //! The calling thread participates in every loop, too.
+    explicit WorkerPool(size_t workers);
+    WorkerPool(WorkerPool const &) = delete;
+    WorkerPool(WorkerPool &&) = delete;
+    WorkerPool &operator=(WorkerPool const &) = delete;
+    WorkerPool &operator=(WorkerPool &&) = delete;
+    ~WorkerPool();
+
+    //! Call `f(i)` for each `i < n` distributing the calls over the workers.
+    //!
+    //! The function returns once all calls have finished. If calls throw, the
+    //! first exception is rethrown.
+    void run(size_t n, std::function<void(size_t)> const &f);
+
+private:
+    //! Execute iterations of the current loop until none are left.
+    void drain_(std::function<void(size_t)> const &f, size_t n);
+    //! The main function of the workers.
+    void work_();
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    //! Signals the start of a loop or the end of the pool.
+    std::condition_variable start_;
+    //! Signals that all workers finished the current loop.
+    std::condition_variable done_;
+    //! The body of the current loop.
+    std::function<void(size_t)> const *job_{nullptr};
+    //! The number of iterations of the current loop.
+    size_t n_{0};
+    //! The next iteration to execute.
+    std::atomic<size_t> next_{0};
+    //! The number of workers that have not finished the current loop.
+    size_t active_{0};
+    //! Incremented for each loop to wake up the workers.
+    uint64_t generation_{0};
+    //! The first exception thrown in the current loop.
+    std::exception_ptr error_;
+    //! Whether the workers have to stop.
+    bool stop_{false};
+};
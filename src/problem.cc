@@ -1,5 +1,9 @@
 #include <problem.hh>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 Relation invert(Relation rel) {
     switch (rel) {
         case Relation::LessEqual: {
@@ -75,3 +79,178 @@ std::ostream &operator<<(std::ostream &out, Inequality const &x) {
     out << " " << x.rel << " " << x.rhs;
     return out;
 }
+
+namespace {
+
+constexpr int32_t MIN_INLINE = -(1 << 30);
+constexpr int32_t MAX_INLINE = (1 << 30) - 1;
+
+[[nodiscard]] size_t hash_mpz(mpz_srcptr x, size_t seed) {
+    auto combine = [&seed](size_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6U) + (seed >> 2U);
+    };
+    combine(static_cast<size_t>(x->_mp_size));
+    for (size_t i = 0, e = mpz_size(x); i != e; ++i) {
+        combine(static_cast<size_t>(mpz_getlimbn(x, i)));
+    }
+    return seed;
+}
+
+} // namespace
+
+size_t Problem::NumberHash::operator()(Number const &x) const {
+    return hash_mpz(x.get_den_mpz_t(), hash_mpz(x.get_num_mpz_t(), 0));
+}
+
+uint32_t Problem::add_var(Clingo::Symbol var) {
+    auto [it, res] = var_ids_.emplace(var, vars_.size());
+    if (res) {
+        vars_.emplace_back(var);
+    }
+    return it->second;
+}
+
+void Problem::add_term(Number const &co, uint32_t var) {
+    if (positions_.size() <= var) {
+        positions_.resize(var + 1, 0);
+    }
+    auto &pos = positions_[var];
+    if (pos == 0) {
+        terms_.emplace_back(var, co);
+        pos = terms_.size();
+    }
+    else {
+        terms_[pos - 1].second += co;
+    }
+}
+
+void Problem::add_row(Number const &rhs, Relation rel, Clingo::literal_t lit) {
+    for (auto const &[var, co] : terms_) {
+        positions_[var] = 0;
+        if (co != 0) {
+            entries_.emplace_back(Entry{var, intern_(co)});
+        }
+    }
+    terms_.clear();
+    offsets_.emplace_back(entries_.size());
+    rhs_.emplace_back(intern_(rhs));
+    rels_.emplace_back(rel);
+    lits_.emplace_back(lit);
+}
+
+void Problem::append(Problem const &problem, size_t offset) {
+    // variables are interned on first use to skip the ones of omitted rows
+    std::vector<uint32_t> ids(problem.num_vars(), std::numeric_limits<uint32_t>::max());
+    for (size_t row = offset, e = problem.size(); row < e; ++row) {
+        for (auto it = problem.begin(row), ie = problem.end(row); it != ie; ++it) {
+            auto &id = ids[it->var];
+            if (id == std::numeric_limits<uint32_t>::max()) {
+                id = add_var(problem.vars_[it->var]);
+            }
+            add_term(problem.number(it->co), id);
+        }
+        add_row(problem.number(problem.rhs(row)), problem.rel(row), problem.lit(row));
+    }
+}
+
+void Problem::append_row(Problem const &problem, size_t row) {
+    for (auto it = problem.begin(row), ie = problem.end(row); it != ie; ++it) {
+        add_term(problem.number(it->co), add_var(problem.vars_[it->var]));
+    }
+    add_row(problem.number(problem.rhs(row)), problem.rel(row), problem.lit(row));
+}
+
+Number Problem::number(Coefficient co) const {
+    if (co.is_inline()) {
+        return {static_cast<int32_t>(co.data_) >> 1};
+    }
+    return pool_[co.data_ >> 1U];
+}
+
+Inequality Problem::inequality(size_t row) const {
+    Inequality x{{}, number(rhs_[row]), rels_[row], lits_[row]};
+    for (auto it = begin(row), ie = end(row); it != ie; ++it) {
+        x.lhs.emplace_back(Term{number(it->co), vars_[it->var]});
+    }
+    return x;
+}
+
+std::vector<size_t> Problem::bandwidth_order() const {
+    auto n_rows = size();
+    auto n_vars = num_vars();
+
+    // the rows of each variable in CSR form
+    std::vector<uint32_t> var_offsets(n_vars + 1, 0);
+    for (auto const &entry : entries_) {
+        ++var_offsets[entry.var + 1];
+    }
+    std::partial_sum(var_offsets.begin(), var_offsets.end(), var_offsets.begin());
+    std::vector<uint32_t> var_rows(entries_.size());
+    auto positions = var_offsets;
+    for (size_t row = 0; row != n_rows; ++row) {
+        for (auto it = begin(row), ie = end(row); it != ie; ++it) {
+            var_rows[positions[it->var]++] = static_cast<uint32_t>(row);
+        }
+    }
+    auto row_degree = [this](size_t row) { return offsets_[row + 1] - offsets_[row]; };
+    auto var_degree = [&var_offsets](uint32_t var) { return var_offsets[var + 1] - var_offsets[var]; };
+
+    std::vector<size_t> starts(n_rows);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), [&](size_t a, size_t b) { return row_degree(a) < row_degree(b); });
+
+    std::vector<bool> row_seen(n_rows, false);
+    std::vector<bool> var_seen(n_vars, false);
+    std::vector<size_t> order;
+    order.reserve(n_rows);
+    std::vector<uint32_t> vars;
+    std::vector<size_t> rows;
+    for (auto start : starts) {
+        if (row_seen[start]) {
+            continue;
+        }
+        row_seen[start] = true;
+        order.emplace_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            auto row = order[head];
+            for (auto it = begin(row), ie = end(row); it != ie; ++it) {
+                if (!var_seen[it->var]) {
+                    var_seen[it->var] = true;
+                    vars.emplace_back(it->var);
+                }
+            }
+            std::stable_sort(vars.begin(), vars.end(), [&](uint32_t a, uint32_t b) { return var_degree(a) < var_degree(b); });
+            for (auto var : vars) {
+                for (auto i = var_offsets[var], e = var_offsets[var + 1]; i != e; ++i) {
+                    if (!row_seen[var_rows[i]]) {
+                        row_seen[var_rows[i]] = true;
+                        rows.emplace_back(var_rows[i]);
+                    }
+                }
+                std::stable_sort(rows.begin(), rows.end(), [&](size_t a, size_t b) { return row_degree(a) < row_degree(b); });
+                order.insert(order.end(), rows.begin(), rows.end());
+                rows.clear();
+            }
+            vars.clear();
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+Problem::Coefficient Problem::intern_(Number const &x) {
+    Coefficient co;
+    if (x.get_den() == 1 && mpz_fits_sint_p(x.get_num_mpz_t()) != 0) {
+        auto value = static_cast<int32_t>(mpz_get_si(x.get_num_mpz_t()));
+        if (MIN_INLINE <= value && value <= MAX_INLINE) {
+            co.data_ = (static_cast<uint32_t>(value) << 1U) | 1U;
+            return co;
+        }
+    }
+    auto [it, res] = pool_ids_.emplace(x, pool_.size());
+    if (res) {
+        pool_.emplace_back(x);
+    }
+    co.data_ = it->second << 1U;
+    return co;
+}
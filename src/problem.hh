@@ -3,6 +3,10 @@
 #include <gmpxx.h>
 #include <clingo.hh>
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 using Number = mpq_class;
 
 enum class Relation {
@@ -32,3 +36,122 @@ struct Inequality {
 };
 
 std::ostream &operator<<(std::ostream &out, Inequality const &x);
+
+//! A compact representation of a set of inequalities.
+//!
+//! Variables are interned to dense ids, coefficients that are not small
+//! integers are stored in a shared pool, and the rows are stored in
+//! compressed sparse row format.
+class Problem {
+public:
+    //! A reference to a number.
+    //!
+    //! Small integers are stored inline and all other numbers refer to the
+    //! pool of the problem.
+    class Coefficient {
+    public:
+        //! Check if the number is stored inline.
+        [[nodiscard]] bool is_inline() const { return (data_ & 1U) != 0; }
+
+    private:
+        friend class Problem;
+        uint32_t data_{1};
+    };
+
+    //! A term of a row.
+    struct Entry {
+        //! The id of the variable.
+        uint32_t var;
+        //! The coefficient of the variable.
+        Coefficient co;
+    };
+
+    //! Intern the given variable returning its id.
+    uint32_t add_var(Clingo::Symbol var);
+
+    //! Add a term to the row currently being constructed.
+    //!
+    //! Terms with the same variable are combined.
+    void add_term(Number const &co, uint32_t var);
+
+    //! Finish the row currently being constructed.
+    //!
+    //! Terms with zero coefficients are dropped.
+    void add_row(Number const &rhs, Relation rel, Clingo::literal_t lit);
+
+    //! Append the rows of another problem starting at the given row.
+    void append(Problem const &problem, size_t offset = 0);
+
+    //! Append a single row of another problem.
+    void append_row(Problem const &problem, size_t row);
+
+    //! Return the number of rows.
+    [[nodiscard]] size_t size() const { return rels_.size(); }
+
+    //! Return the number of variables.
+    [[nodiscard]] size_t num_vars() const { return vars_.size(); }
+
+    //! Return the variable with the given id.
+    [[nodiscard]] Clingo::Symbol var(uint32_t id) const { return vars_[id]; }
+
+    //! Return the first term of the given row.
+    [[nodiscard]] Entry const *begin(size_t row) const { return entries_.data() + offsets_[row]; }
+
+    //! Return the end of the terms of the given row.
+    [[nodiscard]] Entry const *end(size_t row) const { return entries_.data() + offsets_[row + 1]; }
+
+    //! Return the right-hand side of the given row.
+    [[nodiscard]] Coefficient rhs(size_t row) const { return rhs_[row]; }
+
+    //! Return the relation of the given row.
+    [[nodiscard]] Relation rel(size_t row) const { return rels_[row]; }
+
+    //! Return the literal of the given row.
+    [[nodiscard]] Clingo::literal_t lit(size_t row) const { return lits_[row]; }
+
+    //! Return the number a coefficient refers to.
+    [[nodiscard]] Number number(Coefficient co) const;
+
+    //! Return the given row as an inequality.
+    [[nodiscard]] Inequality inequality(size_t row) const;
+
+    //! Return an ordering of the rows reducing the bandwidth of the matrix
+    //! formed by the rows and their variables.
+    //!
+    //! The ordering is computed with the reverse Cuthill-McKee algorithm on
+    //! the bipartite graph of rows and variables. Each connected component is
+    //! traversed breadth-first starting from a row of minimum degree,
+    //! neighbors are visited in order of increasing degree, and the resulting
+    //! order is reversed. Ties are broken by the original order.
+    [[nodiscard]] std::vector<size_t> bandwidth_order() const;
+
+private:
+    struct NumberHash {
+        size_t operator()(Number const &x) const;
+    };
+
+    [[nodiscard]] Coefficient intern_(Number const &x);
+
+    //! The interned variables.
+    std::vector<Clingo::Symbol> vars_;
+    //! Mapping from variables to their ids.
+    std::unordered_map<Clingo::Symbol, uint32_t> var_ids_;
+    //! The pool of coefficients.
+    std::vector<Number> pool_;
+    //! Mapping from numbers to their index in the pool.
+    std::unordered_map<Number, uint32_t, NumberHash> pool_ids_;
+    //! The start offsets of the rows in the entries.
+    std::vector<uint32_t> offsets_{0};
+    //! The terms of all rows.
+    std::vector<Entry> entries_;
+    //! The right-hand sides of the rows.
+    std::vector<Coefficient> rhs_;
+    //! The relations of the rows.
+    std::vector<Relation> rels_;
+    //! The literals of the rows.
+    std::vector<Clingo::literal_t> lits_;
+    //! The terms of the row currently being constructed.
+    std::vector<std::pair<uint32_t, Number>> terms_;
+    //! The position of a variable in the current row's terms or zero.
+    std::vector<uint32_t> positions_;
+};
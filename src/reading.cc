@@ -0,0 +1,855 @@
+#include <reading.hh>
+
+#include <cctype>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+//! The maximum magnitude of a decimal exponent.
+constexpr long MAX_EXPONENT = 4096;
+
+[[noreturn]] void throw_read_error(char const *format, size_t line, char const *message) {
+    throw std::runtime_error(std::string{format} + ": line " + std::to_string(line) + ": " + message);
+}
+
+[[nodiscard]] bool is_digit(char c) {
+    return std::isdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+[[nodiscard]] bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+[[nodiscard]] std::string to_lower(std::string str) {
+    for (auto &c : str) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return str;
+}
+
+//! Parse a number of form `[+-]?[0-9]*(\.[0-9]*)?([eE][+-]?[0-9]+)?(/[0-9]+)?`
+//! containing at least one digit before the optional denominator.
+[[nodiscard]] bool parse_number(std::string const &str, Number &num) {
+    auto it = str.begin();
+    auto ie = str.end();
+    bool negative = false;
+    if (it != ie && (*it == '+' || *it == '-')) {
+        negative = *it == '-';
+        ++it;
+    }
+    std::string digits;
+    long scale = 0;
+    for (; it != ie && is_digit(*it); ++it) {
+        digits.push_back(*it);
+    }
+    if (it != ie && *it == '.') {
+        for (++it; it != ie && is_digit(*it); ++it) {
+            digits.push_back(*it);
+            ++scale;
+        }
+    }
+    if (digits.empty()) {
+        return false;
+    }
+    long exponent = 0;
+    if (it != ie && (*it == 'e' || *it == 'E')) {
+        ++it;
+        bool negative_exponent = false;
+        if (it != ie && (*it == '+' || *it == '-')) {
+            negative_exponent = *it == '-';
+            ++it;
+        }
+        auto ib = it;
+        for (; it != ie && is_digit(*it); ++it) {
+            exponent = exponent * 10 + (*it - '0');
+            if (exponent > MAX_EXPONENT) {
+                return false;
+            }
+        }
+        if (it == ib) {
+            return false;
+        }
+        if (negative_exponent) {
+            exponent = -exponent;
+        }
+    }
+    mpz_class denominator{1};
+    if (it != ie && *it == '/') {
+        auto ib = ++it;
+        for (; it != ie && is_digit(*it); ++it) { }
+        if (it == ib) {
+            return false;
+        }
+        denominator = mpz_class{std::string{ib, it}, 10};
+        if (denominator == 0) {
+            return false;
+        }
+    }
+    if (it != ie) {
+        return false;
+    }
+    exponent -= scale;
+    mpz_class mantissa{digits, 10};
+    mpz_class power;
+    mpz_ui_pow_ui(power.get_mpz_t(), 10, static_cast<unsigned long>(std::abs(exponent)));
+    if (exponent >= 0) {
+        num = Number{mantissa * power, denominator};
+    }
+    else {
+        num = Number{mantissa, power * denominator};
+    }
+    num.canonicalize();
+    if (negative) {
+        num = -num;
+    }
+    return true;
+}
+
+//! Create the symbol for a variable.
+//!
+//! Names that are valid clingo identifiers become constants and all other
+//! names become strings.
+[[nodiscard]] Clingo::Symbol make_var(std::string const &name) {
+    bool ident = !name.empty() && std::islower(static_cast<unsigned char>(name.front())) != 0;
+    for (auto c : name) {
+        ident = ident && (std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '\'');
+    }
+    return ident ? Clingo::Function(name.c_str(), {}) : Clingo::String(name.c_str());
+}
+
+//! Helper to construct a problem keeping track of the bounds of variables.
+class Builder {
+public:
+    explicit Builder(Guard const &guard)
+    : guard_{guard} { }
+
+    //! Return the id of the variable with the given name.
+    uint32_t var(std::string const &name) {
+        auto [it, res] = ids_.emplace(name, 0);
+        if (res) {
+            it->second = problem_.add_var(make_var(name));
+            bounds_.emplace_back(Number{0}, std::nullopt);
+        }
+        return it->second;
+    }
+
+    //! Return the literal guarding the row with the given name.
+    Clingo::literal_t guard(char const *name) {
+        return guard_(name);
+    }
+
+    //! Add a term to the current row.
+    void add_term(Number const &co, uint32_t var) {
+        problem_.add_term(co, var);
+    }
+
+    //! Finish the current row.
+    void add_row(Number const &rhs, Relation rel, Clingo::literal_t lit) {
+        problem_.add_row(rhs, rel, lit);
+    }
+
+    //! Set the lower bound of a variable where no value means unbounded.
+    void set_lower(uint32_t var, std::optional<Number> value) {
+        bounds_[var].first = std::move(value);
+    }
+
+    //! Set the upper bound of a variable where no value means unbounded.
+    void set_upper(uint32_t var, std::optional<Number> value) {
+        bounds_[var].second = std::move(value);
+    }
+
+    //! Add the bounds of the variables and return the problem.
+    Problem finish() {
+        std::optional<Clingo::literal_t> lit;
+        auto add = [&](uint32_t var, Number const &value, Relation rel) {
+            if (!lit) {
+                lit = guard_(nullptr);
+            }
+            problem_.add_term(1, var);
+            problem_.add_row(value, rel, *lit);
+        };
+        for (uint32_t var = 0; var < bounds_.size(); ++var) {
+            auto const &[lower, upper] = bounds_[var];
+            if (lower && upper && *lower == *upper) {
+                add(var, *lower, Relation::Equal);
+                continue;
+            }
+            if (lower) {
+                add(var, *lower, Relation::GreaterEqual);
+            }
+            if (upper) {
+                add(var, *upper, Relation::LessEqual);
+            }
+        }
+        return std::move(problem_);
+    }
+
+private:
+    Guard const &guard_;
+    Problem problem_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::pair<std::optional<Number>, std::optional<Number>>> bounds_;
+};
+
+enum class LPSection {
+    None,
+    Objective,
+    Constraints,
+    Bounds,
+    General,
+    Binary,
+    End,
+};
+
+enum class TokenType {
+    Name,
+    Number,
+    Relation,
+    Plus,
+    Minus,
+    Colon,
+};
+
+struct Token {
+    TokenType type;
+    std::string text;
+    Relation rel{Relation::Equal};
+};
+
+//! Check if a line starts a new section and strip the keyword.
+[[nodiscard]] std::optional<LPSection> lp_section(std::string &line) {
+    size_t ib = 0;
+    for (; ib < line.size() && is_space(line[ib]); ++ib) { }
+    size_t ie = ib;
+    for (; ie < line.size() && !is_space(line[ie]); ++ie) { }
+    auto word = to_lower(line.substr(ib, ie - ib));
+    auto section = [&](LPSection sec) {
+        line.erase(0, ie);
+        return sec;
+    };
+    if (word == "minimize" || word == "minimum" || word == "min" ||
+        word == "maximize" || word == "maximum" || word == "max") {
+        return section(LPSection::Objective);
+    }
+    if (word == "st" || word == "s.t." || word == "st.") {
+        return section(LPSection::Constraints);
+    }
+    if (word == "subject" || word == "such") {
+        size_t jb = ie;
+        for (; jb < line.size() && is_space(line[jb]); ++jb) { }
+        size_t je = jb;
+        for (; je < line.size() && !is_space(line[je]); ++je) { }
+        auto next = to_lower(line.substr(jb, je - jb));
+        if ((word == "subject" && next == "to") || (word == "such" && next == "that")) {
+            ie = je;
+            return section(LPSection::Constraints);
+        }
+    }
+    if (word == "bounds" || word == "bound") {
+        return section(LPSection::Bounds);
+    }
+    if (word == "general" || word == "generals" || word == "gen") {
+        return section(LPSection::General);
+    }
+    if (word == "binary" || word == "binaries" || word == "bin") {
+        return section(LPSection::Binary);
+    }
+    if (word == "end") {
+        return section(LPSection::End);
+    }
+    return std::nullopt;
+}
+
+void lp_tokenize(std::string const &line, std::vector<Token> &tokens) {
+    auto is_name = [](char c) {
+        return !is_space(c) && c != '\\' && c != '<' && c != '>' && c != '=' && c != '+' && c != '-' && c != ':';
+    };
+    size_t n = line.size();
+    for (size_t i = 0; i < n;) {
+        char c = line[i];
+        if (is_space(c)) {
+            ++i;
+        }
+        else if (c == '<' || c == '>' || c == '=') {
+            // Note: `<` and `>` are synonyms for `<=` and `>=` in LP files.
+            char d = i + 1 < n ? line[i + 1] : '\0';
+            auto rel = Relation::Equal;
+            if (c == '<' || (c == '=' && d == '<')) {
+                rel = Relation::LessEqual;
+            }
+            else if (c == '>' || (c == '=' && d == '>')) {
+                rel = Relation::GreaterEqual;
+            }
+            i += (c != '=' && d == '=') || (c == '=' && rel != Relation::Equal) ? 2 : 1;
+            tokens.emplace_back(Token{TokenType::Relation, "", rel});
+        }
+        else if (c == '+' || c == '-' || c == ':') {
+            tokens.emplace_back(Token{c == '+' ? TokenType::Plus : c == '-' ? TokenType::Minus : TokenType::Colon, "", Relation::Equal});
+            ++i;
+        }
+        else if (is_digit(c) || (c == '.' && i + 1 < n && is_digit(line[i + 1]))) {
+            size_t j = i;
+            for (; j < n && is_digit(line[j]); ++j) { }
+            if (j < n && line[j] == '.') {
+                for (++j; j < n && is_digit(line[j]); ++j) { }
+            }
+            if (j < n && (line[j] == 'e' || line[j] == 'E')) {
+                size_t k = j + 1;
+                if (k < n && (line[k] == '+' || line[k] == '-')) {
+                    ++k;
+                }
+                if (k < n && is_digit(line[k])) {
+                    for (j = k; j < n && is_digit(line[j]); ++j) { }
+                }
+            }
+            if (j + 1 < n && line[j] == '/' && is_digit(line[j + 1])) {
+                for (++j; j < n && is_digit(line[j]); ++j) { }
+            }
+            tokens.emplace_back(Token{TokenType::Number, line.substr(i, j - i), Relation::Equal});
+            i = j;
+        }
+        else {
+            size_t j = i;
+            for (; j < n && is_name(line[j]); ++j) { }
+            tokens.emplace_back(Token{TokenType::Name, line.substr(i, j - i), Relation::Equal});
+            i = j;
+        }
+    }
+}
+
+[[nodiscard]] bool is_infinity(Token const &token) {
+    if (token.type != TokenType::Name) {
+        return false;
+    }
+    auto name = to_lower(token.text);
+    return name == "inf" || name == "infinity";
+}
+
+class LPReader {
+public:
+    LPReader(std::istream &in, Guard const &guard)
+    : in_{in}
+    , builder_{guard} { }
+
+    Problem read() {
+        std::string line;
+        while (section_ != LPSection::End && std::getline(in_, line)) {
+            ++line_;
+            if (auto pos = line.find('\\'); pos != std::string::npos) {
+                line.erase(pos);
+            }
+            if (auto section = lp_section(line)) {
+                if (!tokens_.empty()) {
+                    error("incomplete constraint");
+                }
+                section_ = *section;
+            }
+            switch (section_) {
+                case LPSection::None: {
+                    tokens_.clear();
+                    lp_tokenize(line, tokens_);
+                    if (!tokens_.empty()) {
+                        error("expected section");
+                    }
+                    break;
+                }
+                case LPSection::Objective:
+                case LPSection::General:
+                case LPSection::End: {
+                    break;
+                }
+                case LPSection::Constraints: {
+                    lp_tokenize(line, tokens_);
+                    read_constraints_();
+                    break;
+                }
+                case LPSection::Bounds: {
+                    lp_tokenize(line, tokens_);
+                    read_bound_();
+                    tokens_.clear();
+                    break;
+                }
+                case LPSection::Binary: {
+                    lp_tokenize(line, tokens_);
+                    for (auto const &token : tokens_) {
+                        if (token.type != TokenType::Name) {
+                            error("expected variable");
+                        }
+                        auto var = builder_.var(token.text);
+                        builder_.set_lower(var, Number{0});
+                        builder_.set_upper(var, Number{1});
+                    }
+                    tokens_.clear();
+                    break;
+                }
+            }
+        }
+        if (!tokens_.empty()) {
+            error("incomplete constraint");
+        }
+        return builder_.finish();
+    }
+
+private:
+    [[noreturn]] void error(char const *message) const {
+        throw_read_error("LP", line_, message);
+    }
+
+    [[nodiscard]] Number number_(Token const &token) const {
+        Number num;
+        if (!parse_number(token.text, num)) {
+            error("invalid number");
+        }
+        return num;
+    }
+
+    //! Parse a signed number or infinity starting at position i.
+    //!
+    //! Infinite values are represented by an empty optional.
+    [[nodiscard]] std::optional<Number> value_(size_t &i) const {
+        bool negative = false;
+        for (; i < tokens_.size() && (tokens_[i].type == TokenType::Plus || tokens_[i].type == TokenType::Minus); ++i) {
+            negative = negative != (tokens_[i].type == TokenType::Minus);
+        }
+        if (i < tokens_.size() && is_infinity(tokens_[i])) {
+            ++i;
+            return std::nullopt;
+        }
+        if (i >= tokens_.size() || tokens_[i].type != TokenType::Number) {
+            error("expected number");
+        }
+        auto num = number_(tokens_[i++]);
+        if (negative) {
+            num = -num;
+        }
+        return num;
+    }
+
+    //! Read all complete constraints in the token buffer.
+    void read_constraints_() {
+        while (true) {
+            // a constraint is complete once the number after the relation
+            // has been read
+            size_t end = 0;
+            for (size_t i = 0; i < tokens_.size(); ++i) {
+                if (tokens_[i].type == TokenType::Relation) {
+                    size_t j = i + 1;
+                    for (; j < tokens_.size() && (tokens_[j].type == TokenType::Plus || tokens_[j].type == TokenType::Minus); ++j) { }
+                    if (j < tokens_.size()) {
+                        end = j + 1;
+                    }
+                    break;
+                }
+            }
+            if (end == 0) {
+                return;
+            }
+            read_constraint_(end);
+            tokens_.erase(tokens_.begin(), tokens_.begin() + static_cast<std::ptrdiff_t>(end));
+        }
+    }
+
+    void read_constraint_(size_t end) {
+        size_t i = 0;
+        std::string name;
+        if (end > 2 && tokens_[0].type == TokenType::Name && tokens_[1].type == TokenType::Colon) {
+            name = tokens_[0].text;
+            i = 2;
+        }
+        else {
+            name = "c" + std::to_string(n_constraints_ + 1);
+        }
+        ++n_constraints_;
+        while (tokens_[i].type != TokenType::Relation) {
+            Number co{1};
+            for (; tokens_[i].type == TokenType::Plus || tokens_[i].type == TokenType::Minus; ++i) {
+                if (tokens_[i].type == TokenType::Minus) {
+                    co = -co;
+                }
+            }
+            if (tokens_[i].type == TokenType::Number) {
+                co *= number_(tokens_[i++]);
+            }
+            if (tokens_[i].type != TokenType::Name) {
+                error("expected variable");
+            }
+            builder_.add_term(co, builder_.var(tokens_[i++].text));
+        }
+        auto rel = tokens_[i++].rel;
+        auto rhs = value_(i);
+        if (!rhs) {
+            error("expected number");
+        }
+        builder_.add_row(*rhs, rel, builder_.guard(name.c_str()));
+    }
+
+    //! Read a bound of form `x free`, `x op v`, `v op x`, or `v op x op v`.
+    void read_bound_() {
+        if (tokens_.empty()) {
+            return;
+        }
+        if (tokens_.size() == 2 && tokens_[0].type == TokenType::Name && to_lower(tokens_[1].text) == "free") {
+            auto var = builder_.var(tokens_[0].text);
+            builder_.set_lower(var, std::nullopt);
+            builder_.set_upper(var, std::nullopt);
+            return;
+        }
+        auto bound = [&](uint32_t var, Relation rel, std::optional<Number> const &value) {
+            if (rel != Relation::LessEqual) {
+                builder_.set_lower(var, value);
+            }
+            if (rel != Relation::GreaterEqual) {
+                builder_.set_upper(var, value);
+            }
+        };
+        auto relation = [&](size_t &i) {
+            if (i >= tokens_.size() || tokens_[i].type != TokenType::Relation) {
+                error("expected relation");
+            }
+            return tokens_[i++].rel;
+        };
+        auto variable = [&](size_t &i) {
+            if (i >= tokens_.size() || tokens_[i].type != TokenType::Name || is_infinity(tokens_[i])) {
+                error("expected variable");
+            }
+            return builder_.var(tokens_[i++].text);
+        };
+        size_t i = 0;
+        if (tokens_[0].type == TokenType::Name && !is_infinity(tokens_[0])) {
+            auto var = variable(i);
+            auto rel = relation(i);
+            bound(var, rel, value_(i));
+        }
+        else {
+            auto value = value_(i);
+            auto rel = relation(i);
+            auto var = variable(i);
+            bound(var, invert(rel), value);
+            if (i < tokens_.size()) {
+                rel = relation(i);
+                bound(var, rel, value_(i));
+            }
+        }
+        if (i != tokens_.size()) {
+            error("invalid bound");
+        }
+    }
+
+    std::istream &in_;
+    Builder builder_;
+    std::vector<Token> tokens_;
+    LPSection section_{LPSection::None};
+    size_t line_{0};
+    size_t n_constraints_{0};
+};
+
+enum class MPSSection {
+    None,
+    Name,
+    ObjSense,
+    Rows,
+    Columns,
+    Rhs,
+    Ranges,
+    Bounds,
+};
+
+class MPSReader {
+public:
+    MPSReader(std::istream &in, Guard const &guard)
+    : in_{in}
+    , builder_{guard} { }
+
+    Problem read() {
+        std::string line;
+        while (std::getline(in_, line)) {
+            ++line_;
+            if (line.empty() || line.front() == '*') {
+                continue;
+            }
+            split_(line);
+            if (fields_.empty()) {
+                continue;
+            }
+            // section headers start in the first column
+            if (!is_space(line.front())) {
+                auto const &key = fields_.front();
+                if (key == "ENDATA") {
+                    break;
+                }
+                if (key == "NAME") {
+                    section_ = MPSSection::Name;
+                }
+                else if (key == "OBJSENSE") {
+                    section_ = MPSSection::ObjSense;
+                }
+                else if (key == "ROWS") {
+                    section_ = MPSSection::Rows;
+                }
+                else if (key == "COLUMNS") {
+                    section_ = MPSSection::Columns;
+                }
+                else if (key == "RHS") {
+                    section_ = MPSSection::Rhs;
+                }
+                else if (key == "RANGES") {
+                    section_ = MPSSection::Ranges;
+                }
+                else if (key == "BOUNDS") {
+                    section_ = MPSSection::Bounds;
+                }
+                else {
+                    error("unknown section");
+                }
+                continue;
+            }
+            switch (section_) {
+                case MPSSection::None: {
+                    error("expected section");
+                }
+                case MPSSection::Name:
+                case MPSSection::ObjSense: {
+                    break;
+                }
+                case MPSSection::Rows: {
+                    read_row_();
+                    break;
+                }
+                case MPSSection::Columns: {
+                    read_column_();
+                    break;
+                }
+                case MPSSection::Rhs:
+                case MPSSection::Ranges: {
+                    read_rhs_(section_ == MPSSection::Ranges);
+                    break;
+                }
+                case MPSSection::Bounds: {
+                    read_bound_();
+                    break;
+                }
+            }
+        }
+
+        for (auto &row : rows_) {
+            if (row.type == 'N') {
+                continue;
+            }
+            auto lit = builder_.guard(row.name.c_str());
+            auto add = [&](Number const &rhs, Relation rel) {
+                for (auto const &[var, co] : row.terms) {
+                    builder_.add_term(co, var);
+                }
+                builder_.add_row(rhs, rel, lit);
+            };
+            if (!row.range) {
+                add(row.rhs, row.type == 'L' ? Relation::LessEqual : row.type == 'G' ? Relation::GreaterEqual : Relation::Equal);
+            }
+            else {
+                // ranges turn a row into a lower and an upper bound
+                Number range = abs(*row.range);
+                bool lower = row.type == 'G' || (row.type == 'E' && *row.range >= 0);
+                add(lower ? row.rhs : Number{row.rhs - range}, Relation::GreaterEqual);
+                add(lower ? Number{row.rhs + range} : row.rhs, Relation::LessEqual);
+            }
+            row.terms.clear();
+            row.terms.shrink_to_fit();
+        }
+        return builder_.finish();
+    }
+
+private:
+    struct Row {
+        std::string name;
+        char type;
+        std::vector<std::pair<uint32_t, Number>> terms;
+        Number rhs;
+        std::optional<Number> range;
+    };
+
+    [[noreturn]] void error(char const *message) const {
+        throw_read_error("MPS", line_, message);
+    }
+
+    void split_(std::string const &line) {
+        fields_.clear();
+        for (size_t i = 0, n = line.size(); i < n;) {
+            if (is_space(line[i])) {
+                ++i;
+                continue;
+            }
+            size_t j = i;
+            for (; j < n && !is_space(line[j]); ++j) { }
+            fields_.emplace_back(line.substr(i, j - i));
+            i = j;
+        }
+    }
+
+    [[nodiscard]] Number number_(std::string const &str) const {
+        Number num;
+        if (!parse_number(str, num)) {
+            error("invalid number");
+        }
+        return num;
+    }
+
+    //! Return the row with the given name or a null pointer for rows of type
+    //! `N`.
+    [[nodiscard]] Row *row_(std::string const &name) {
+        auto it = row_ids_.find(name);
+        if (it == row_ids_.end()) {
+            error("unknown row");
+        }
+        auto &row = rows_[it->second];
+        return row.type != 'N' ? &row : nullptr;
+    }
+
+    void read_row_() {
+        if (fields_.size() != 2 || fields_[0].size() != 1 || std::string{"NLGE"}.find(fields_[0][0]) == std::string::npos) {
+            error("invalid row");
+        }
+        if (!row_ids_.emplace(fields_[1], rows_.size()).second) {
+            error("duplicate row");
+        }
+        rows_.emplace_back(Row{fields_[1], fields_[0][0], {}, Number{0}, std::nullopt});
+    }
+
+    void read_column_() {
+        if (fields_.size() >= 3 && fields_[1] == "'MARKER'") {
+            return;
+        }
+        if (fields_.size() != 3 && fields_.size() != 5) {
+            error("invalid column");
+        }
+        auto var = builder_.var(fields_[0]);
+        for (size_t i = 1; i + 1 < fields_.size(); i += 2) {
+            if (auto *row = row_(fields_[i]); row != nullptr) {
+                row->terms.emplace_back(var, number_(fields_[i + 1]));
+            }
+        }
+    }
+
+    void read_rhs_(bool range) {
+        if (fields_.size() < 2 || fields_.size() > 5) {
+            error(range ? "invalid range" : "invalid right-hand side");
+        }
+        // skip the optional name of the vector
+        for (size_t i = fields_.size() % 2; i + 1 < fields_.size(); i += 2) {
+            if (auto *row = row_(fields_[i]); row != nullptr) {
+                if (range) {
+                    row->range = number_(fields_[i + 1]);
+                }
+                else {
+                    row->rhs = number_(fields_[i + 1]);
+                }
+            }
+        }
+    }
+
+    void read_bound_() {
+        if (fields_.empty()) {
+            error("invalid bound");
+        }
+        auto const &type = fields_[0];
+        bool has_value = type != "FR" && type != "MI" && type != "PL" && type != "BV";
+        size_t n = has_value ? 3 : 2;
+        if (fields_.size() != n && fields_.size() != n + 1) {
+            error("invalid bound");
+        }
+        auto var = builder_.var(fields_[fields_.size() - (has_value ? 2 : 1)]);
+        std::optional<Number> value;
+        if (has_value) {
+            value = number_(fields_.back());
+            // by convention, values with a magnitude of at least 1e30 are
+            // infinite
+            if (abs(*value) >= Number{mpz_class{"1000000000000000000000000000000"}}) {
+                value = std::nullopt;
+            }
+        }
+        if (type == "UP" || type == "UI") {
+            builder_.set_upper(var, value);
+        }
+        else if (type == "LO" || type == "LI") {
+            builder_.set_lower(var, value);
+        }
+        else if (type == "FX") {
+            builder_.set_lower(var, value);
+            builder_.set_upper(var, value);
+        }
+        else if (type == "FR") {
+            builder_.set_lower(var, std::nullopt);
+            builder_.set_upper(var, std::nullopt);
+        }
+        else if (type == "MI") {
+            builder_.set_lower(var, std::nullopt);
+        }
+        else if (type == "PL") {
+            builder_.set_upper(var, std::nullopt);
+        }
+        else if (type == "BV") {
+            builder_.set_lower(var, Number{0});
+            builder_.set_upper(var, Number{1});
+        }
+        else {
+            error("unknown bound type");
+        }
+    }
+
+    std::istream &in_;
+    Builder builder_;
+    std::vector<std::string> fields_;
+    std::vector<Row> rows_;
+    std::unordered_map<std::string, size_t> row_ids_;
+    MPSSection section_{MPSSection::None};
+    size_t line_{0};
+};
+
+} // namespace
+
+Problem read_lp(std::istream &in, Guard const &guard) {
+    return LPReader{in, guard}.read();
+}
+
+Problem read_mps(std::istream &in, Guard const &guard) {
+    return MPSReader{in, guard}.read();
+}
+
+std::vector<std::string> read_basis(std::istream &in) {
+    std::vector<std::string> basic;
+    std::string line;
+    for (size_t num = 1; std::getline(in, line); ++num) {
+        if (line.empty() || line.front() == '*') {
+            continue;
+        }
+        std::istringstream iss{line};
+        std::string key;
+        std::string name;
+        if (!(iss >> key)) {
+            continue;
+        }
+        // section headers start in the first column
+        if (!is_space(line.front())) {
+            if (key == "ENDATA") {
+                break;
+            }
+            if (key != "NAME") {
+                throw_read_error("basis", num, "unknown section");
+            }
+            continue;
+        }
+        if (!(iss >> name)) {
+            throw_read_error("basis", num, "expected name");
+        }
+        if (key == "XU" || key == "XL" || key == "BS") {
+            basic.emplace_back(std::move(name));
+        }
+        else if (key != "LL" && key != "UL") {
+            throw_read_error("basis", num, "unknown indicator");
+        }
+    }
+    return basic;
+}
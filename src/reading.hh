@@ -0,0 +1,36 @@
+#pragma once
+
+#include <problem.hh>
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+//! Callback to obtain the literal guarding a row.
+//!
+//! The callback is called with the name of a row or a null pointer for the
+//! bounds of variables.
+using Guard = std::function<Clingo::literal_t (char const *name)>;
+
+//! Read a problem in CPLEX LP format.
+//!
+//! Rows are added as soon as they have been read. The objective function as
+//! well as integrality constraints are ignored. Variables have a default
+//! lower bound of zero. Besides decimals, numbers can be fractions like
+//! `1/3`.
+[[nodiscard]] Problem read_lp(std::istream &in, Guard const &guard);
+
+//! Read a problem in free MPS format.
+//!
+//! The objective function as well as integrality markers are ignored.
+//! Variables have a default lower bound of zero. Besides decimals, numbers
+//! can be fractions like `1/3`.
+[[nodiscard]] Problem read_mps(std::istream &in, Guard const &guard);
+
+//! Read the names of the basic variables from a file in MPS basis format.
+//!
+//! For entries `XU` and `XL`, the first name is basic and the second one is
+//! the row whose logical is non-basic. Entries `BS` name basic variables and
+//! entries `LL` and `UL` non-basic ones.
+[[nodiscard]] std::vector<std::string> read_basis(std::istream &in);
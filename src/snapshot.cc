@@ -0,0 +1,181 @@
+#include <snapshot.hh>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+//! Marker to detect snapshots written with a different byte order.
+constexpr uint32_t BYTE_ORDER_MARKER = 0x01020304;
+
+//! The magic bytes at the start of each snapshot.
+constexpr char const *MAGIC = "CLPXSNAP";
+constexpr size_t MAGIC_SIZE = 8;
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(std::ostream &out)
+: out_{out} {
+    out_.write(MAGIC, MAGIC_SIZE);
+    write_u32(BYTE_ORDER_MARKER);
+    write_u32(snapshot_version);
+}
+
+void SnapshotWriter::write_u32(uint32_t x) {
+    out_.write(reinterpret_cast<char const *>(&x), sizeof(x));
+}
+
+void SnapshotWriter::write_u64(uint64_t x) {
+    out_.write(reinterpret_cast<char const *>(&x), sizeof(x));
+}
+
+void SnapshotWriter::write_i32(int32_t x) {
+    out_.write(reinterpret_cast<char const *>(&x), sizeof(x));
+}
+
+void SnapshotWriter::write_string(std::string const &x) {
+    write_u64(x.size());
+    out_.write(x.data(), static_cast<std::streamsize>(x.size()));
+}
+
+void SnapshotWriter::write_number(Number const &x) {
+    write_mpz_(x.get_num_mpz_t());
+    write_mpz_(x.get_den_mpz_t());
+}
+
+void SnapshotWriter::write_mpz_(mpz_srcptr x) {
+    // the size is negative for negative numbers
+    size_t count = (mpz_sizeinbase(x, 2) + 63) / 64;
+    int32_t size = mpz_sgn(x) == 0 ? 0 : static_cast<int32_t>(count);
+    write_i32(mpz_sgn(x) < 0 ? -size : size);
+    if (size > 0) {
+        std::vector<uint64_t> limbs(count);
+        mpz_export(limbs.data(), &count, -1, sizeof(uint64_t), 0, 0, x);
+        out_.write(reinterpret_cast<char const *>(limbs.data()), static_cast<std::streamsize>(count * sizeof(uint64_t)));
+    }
+}
+
+SnapshotReader::SnapshotReader(char const *data, size_t size)
+: data_{data}
+, end_{data + size} {
+    char magic[MAGIC_SIZE];
+    read_(magic, MAGIC_SIZE);
+    if (std::memcmp(magic, MAGIC, MAGIC_SIZE) != 0) {
+        throw std::runtime_error("invalid snapshot");
+    }
+    if (read_u32() != BYTE_ORDER_MARKER) {
+        throw std::runtime_error("snapshot has been written with a different byte order");
+    }
+    if (read_u32() != snapshot_version) {
+        throw std::runtime_error("snapshot has been written with a different version");
+    }
+}
+
+uint32_t SnapshotReader::read_u32() {
+    uint32_t x = 0;
+    read_(&x, sizeof(x));
+    return x;
+}
+
+uint64_t SnapshotReader::read_u64() {
+    uint64_t x = 0;
+    read_(&x, sizeof(x));
+    return x;
+}
+
+int32_t SnapshotReader::read_i32() {
+    int32_t x = 0;
+    read_(&x, sizeof(x));
+    return x;
+}
+
+std::string SnapshotReader::read_string() {
+    auto size = read_u64();
+    if (size > static_cast<size_t>(end_ - data_)) {
+        throw std::runtime_error("truncated snapshot");
+    }
+    std::string x{data_, size};
+    data_ += size;
+    return x;
+}
+
+Number SnapshotReader::read_number() {
+    Number x;
+    read_mpz_(x.get_num_mpz_t());
+    read_mpz_(x.get_den_mpz_t());
+    if (mpz_sgn(x.get_den_mpz_t()) <= 0) {
+        throw std::runtime_error("invalid snapshot");
+    }
+    return x;
+}
+
+void SnapshotReader::read_(void *data, size_t size) {
+    if (size > static_cast<size_t>(end_ - data_)) {
+        throw std::runtime_error("truncated snapshot");
+    }
+    std::memcpy(data, data_, size);
+    data_ += size;
+}
+
+void SnapshotReader::read_mpz_(mpz_ptr x) {
+    auto size = read_i32();
+    size_t count = size < 0 ? -static_cast<int64_t>(size) : size;
+    if (count > static_cast<size_t>(end_ - data_) / sizeof(uint64_t)) {
+        throw std::runtime_error("truncated snapshot");
+    }
+    // Note: the limbs are copied because the buffer is not necessarily
+    // aligned.
+    std::vector<uint64_t> limbs(count);
+    read_(limbs.data(), count * sizeof(uint64_t));
+    mpz_import(x, count, -1, sizeof(uint64_t), 0, 0, limbs.data());
+    if (size < 0) {
+        mpz_neg(x, x);
+    }
+}
+
+MappedFile::MappedFile(char const *path) {
+#ifdef __unix__
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                data_ = static_cast<char const *>(data);
+                size_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+            }
+        }
+        close(fd);
+        if (mapped_) {
+            return;
+        }
+    }
+#endif
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::runtime_error(std::string{"could not open file: "} + path);
+    }
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    buffer_ = oss.str();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {
+#ifdef __unix__
+    if (mapped_) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <util.hh>
+
+#include <ostream>
+#include <string>
+
+//! The version of the snapshot format.
+//!
+//! It has to be incremented whenever the layout of snapshots changes.
+constexpr uint32_t snapshot_version = 1;
+
+//! Write binary snapshots.
+//!
+//! Integers are written in native byte order and numbers as sequences of
+//! 64-bit limbs. A marker in the header ensures that snapshots are only read
+//! on machines with the same byte order.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ostream &out);
+
+    void write_u32(uint32_t x);
+    void write_u64(uint64_t x);
+    void write_i32(int32_t x);
+    void write_string(std::string const &x);
+    void write_number(Number const &x);
+
+private:
+    void write_mpz_(mpz_srcptr x);
+
+    std::ostream &out_;
+};
+
+//! Read binary snapshots from a memory buffer.
+//!
+//! All functions throw an exception if the buffer is too small.
+class SnapshotReader {
+public:
+    SnapshotReader(char const *data, size_t size);
+
+    [[nodiscard]] uint32_t read_u32();
+    [[nodiscard]] uint64_t read_u64();
+    [[nodiscard]] int32_t read_i32();
+    [[nodiscard]] std::string read_string();
+    [[nodiscard]] Number read_number();
+
+    //! Return the number of bytes left in the buffer.
+    [[nodiscard]] size_t remaining() const { return static_cast<size_t>(end_ - data_); }
+
+private:
+    void read_(void *data, size_t size);
+    void read_mpz_(mpz_ptr x);
+
+    char const *data_;
+    char const *end_;
+};
+
+//! A read-only file mapped into memory.
+//!
+//! If memory mapping is not available, the file is read into a buffer.
+class MappedFile {
+public:
+    explicit MappedFile(char const *path);
+    MappedFile(MappedFile const &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] char const *data() const { return data_; }
+    [[nodiscard]] size_t size() const { return size_; }
+
+private:
+    std::string buffer_;
+    char const *data_{nullptr};
+    size_t size_{0};
+    bool mapped_{false};
+};
@@ -1,7 +1,191 @@
 #include <solving.hh>
 #include <parsing.hh>
+#include <reading.hh>
+#include <snapshot.hh>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+//! The number of pivots after which the memory of a solver is sampled.
+constexpr size_t MEMORY_SAMPLE_INTERVAL = 1024;
+
+void add_memory_statistics(Clingo::UserStatistics stats, Memory const &mem, size_t total, bool peak) {
+    auto set = [&](char const *name, size_t value) {
+        auto stats_value = stats.add_subkey(name, Clingo::StatisticsType::Value);
+        stats_value.set_value(peak ? std::max(stats_value.value(), static_cast<double>(value)) : value);
+    };
+    set("Tableau", mem.tableau);
+    set("Original Tableau", mem.original_tableau);
+    set("Difference Logic", mem.difference);
+    set("Bound Trail", mem.bound_trail);
+    set("Assignment Trail", mem.assignment_trail);
+    set("Bounds", mem.bounds);
+    set("Variables", mem.variables);
+    set("Total", total);
+}
+
+#ifdef CLINGOLPX_PERF
+void add_perf_statistics(Clingo::UserStatistics stats, PerfCounters const &perf, bool accumulate) {
+    for (size_t i = 0; i < perf_num_phases; ++i) {
+        auto phase = static_cast<PerfPhase>(i);
+        auto stats_phase = stats.add_subkey(perf_name(phase), Clingo::StatisticsType::Map);
+        auto stats_calls = stats_phase.add_subkey("Calls", Clingo::StatisticsType::Value);
+        stats_calls.set_value((accumulate ? stats_calls.value() : 0) + perf.calls(phase));
+        for (size_t j = 0; j < perf_num_counters; ++j) {
+            auto counter = static_cast<PerfCounter>(j);
+            if (perf.available(counter)) {
+                auto stats_counter = stats_phase.add_subkey(perf_name(counter), Clingo::StatisticsType::Value);
+                stats_counter.set_value((accumulate ? stats_counter.value() : 0) + perf.value(phase, counter));
+            }
+        }
+    }
+}
+#endif
+
+//! Return the positive factor scaling the coefficients of a row to integers
+//! whose greatest common divisor is one.
+[[nodiscard]] Number row_scale(Problem const &problem, Problem::Entry const *ib, Problem::Entry const *ie) {
+    mpz_class num{0};
+    mpz_class den{1};
+    for (auto const *it = ib; it != ie; ++it) {
+        auto a = problem.number(it->co);
+        mpz_gcd(num.get_mpz_t(), num.get_mpz_t(), a.get_num_mpz_t());
+        mpz_lcm(den.get_mpz_t(), den.get_mpz_t(), a.get_den_mpz_t());
+    }
+    if (num == 0) {
+        return Number{1};
+    }
+    Number ret{den, num};
+    ret.canonicalize();
+    return ret;
+}
+
+//! Check if `0 rel rhs` holds.
+[[nodiscard]] bool holds_zero(Relation rel, Number const &rhs) {
+    switch (rel) {
+        case Relation::Less: {
+            return 0 < rhs;
+        }
+        case Relation::LessEqual: {
+            return 0 <= rhs;
+        }
+        case Relation::Greater: {
+            return 0 > rhs;
+        }
+        case Relation::GreaterEqual: {
+            return 0 >= rhs;
+        }
+        case Relation::Equal: {
+            break;
+        }
+    }
+    return rhs == 0;
+}
+
+void write_value(SnapshotWriter &out, Number const &x) {
+    out.write_number(x);
+}
+
+void write_value(SnapshotWriter &out, NumberQ const &x) {
+    out.write_number(x.c());
+    out.write_number(x.k());
+}
+
+template <typename Value>
+[[nodiscard]] Value read_value(SnapshotReader &in);
 
-#include <unordered_set>
+template <>
+[[nodiscard]] Number read_value<Number>(SnapshotReader &in) {
+    return in.read_number();
+}
+
+template <>
+[[nodiscard]] NumberQ read_value<NumberQ>(SnapshotReader &in) {
+    auto c = in.read_number();
+    return NumberQ{std::move(c), in.read_number()};
+}
+
+//! The number of terms written per line of an LP file.
+constexpr size_t LP_TERMS_PER_LINE = 8;
+
+[[nodiscard]] Number const &rational_part(Number const &x) {
+    return x;
+}
+
+[[nodiscard]] Number const &rational_part(NumberQ const &x) {
+    return x.c();
+}
+
+[[nodiscard]] bool is_strict(Number const &x) {
+    static_cast<void>(x);
+    return false;
+}
+
+[[nodiscard]] bool is_strict(NumberQ const &x) {
+    return x.k() != 0;
+}
+
+//! Convert a value to a symbol for reporting it in models.
+[[nodiscard]] Clingo::Symbol value_symbol(Number const &x) {
+    if (x.get_den() == 1 && mpz_fits_sint_p(x.get_num_mpz_t()) != 0) {
+        return Clingo::Number(static_cast<int>(mpz_get_si(x.get_num_mpz_t())));
+    }
+    std::ostringstream oss;
+    oss << x;
+    return Clingo::String(oss.str().c_str());
+}
+
+[[nodiscard]] Clingo::Symbol value_symbol(NumberQ const &x) {
+    if (x.k() == 0) {
+        return value_symbol(x.c());
+    }
+    std::ostringstream oss;
+    oss << x;
+    return Clingo::String(oss.str().c_str());
+}
+
+//! Check if a name can be used unchanged in LP and MPS files.
+//!
+//! Such names start with a letter that could not be mistaken for an exponent
+//! and are not keywords of the LP format.
+[[nodiscard]] bool is_export_name(std::string const &name) {
+    static std::array<char const *, 12> const keywords{
+        "bin", "bound", "bounds", "end", "free", "gen", "inf", "infinity", "max", "min", "st", "subject"};
+    if (name.empty() ||
+        std::isalpha(static_cast<unsigned char>(name.front())) == 0 ||
+        name.front() == 'e' || name.front() == 'E') {
+        return false;
+    }
+    for (auto c : name) {
+        if (std::isalnum(static_cast<unsigned char>(c)) == 0 && std::strchr("_().,'", c) == nullptr) {
+            return false;
+        }
+    }
+    return std::none_of(keywords.begin(), keywords.end(), [&name](char const *keyword) {
+        return name == keyword;
+    });
+}
+
+//! Update a 64-bit FNV-1a hash with the characters of a string.
+[[nodiscard]] uint64_t hash_string(uint64_t hash, std::string const &str) {
+    for (auto c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= UINT64_C(0x100000001b3);
+    }
+    return hash;
+}
+
+} // namespace
 
 template<typename Factor, typename Value>
 typename Solver<Factor, Value>::BoundRelation bound_rel(Relation rel) {
@@ -50,71 +234,170 @@ NumberQ bound_val<NumberQ>(Number &&x, Relation rel) {
 
 template<typename Factor, typename Value>
 struct Solver<Factor, Value>::Prepare {
-    index_t add_non_basic(Solver &s, Clingo::Symbol var) {
-        auto [jt, res] = s.indices_.emplace(var, n_vars);
-        if (res) {
-            s.variables_.emplace_back();
-            // Note: that this makes it possible to use `Solver::non_basic_`
-            // during initialization
-            s.variables_[s.n_non_basic_].index = n_vars;
-            s.variables_[n_vars].reserve_index = s.n_non_basic_;
-            ++n_vars;
-            ++s.n_non_basic_;
-        }
-        return s.variables_[jt->second].reserve_index;
-    }
-
-    index_t add_basic(Solver &s) {
-        basic.emplace_back(n_vars);
-        s.variables_.emplace_back();
-        ++n_vars;
-        return basic.size() - 1;
-    }
-
-    std::vector<std::pair<index_t, Number>> add_row(Solver &s, Inequality const &x) {
-        std::vector<std::pair<index_t, Number>> row;
-        std::vector<Clingo::Symbol> vars;
-        std::unordered_map<Clingo::Symbol, Number> cos;
-
-        // combine cofficients
-        for (auto const &y : x.lhs) {
-            if (y.co == 0) {
+    Prepare(Solver &s, Problem const &problem)
+    : ids(problem.num_vars(), std::numeric_limits<index_t>::max())
+    , n_non_basic{s.n_non_basic_}
+    , n_basic{s.n_basic_}
+    , original_cols(s.variables_.size(), std::numeric_limits<index_t>::max()) {
+        for (index_t j = 0; j < s.original_non_basic_.size(); ++j) {
+            original_cols[s.original_non_basic_[j]] = j;
+        }
+    }
+
+    //! Get the solver variable for a variable of the problem.
+    //!
+    //! Variables that do not exist yet are added as non-basic variables.
+    index_t add_var(Solver &s, Problem const &problem, uint32_t var) {
+        auto &id = ids[var];
+        if (id == std::numeric_limits<index_t>::max()) {
+            auto sym = problem.var(var);
+            auto res = s.var_ids_.try_emplace(sym, s.variables_.size());
+            id = res.first->second;
+            if (res.second) {
+                s.add_var_();
+                original_cols.resize(s.variables_.size(), std::numeric_limits<index_t>::max());
+                original_cols[id] = s.original_non_basic_.size() + non_basic.size();
+                non_basic.emplace_back(id);
+                if (sym.type() != Clingo::SymbolType::Number) {
+                    symbols.emplace_back(sym, id);
+                }
+            }
+        }
+        return id;
+    }
+
+    //! Get the node of the difference logic engine for a variable of the
+    //! problem.
+    //!
+    //! Nodes that do not exist yet are added to the engine.
+    index_t add_node(Solver &s, Problem const &problem, uint32_t var) {
+        auto &id = ids[var];
+        if (id == std::numeric_limits<index_t>::max()) {
+            auto sym = problem.var(var);
+            auto res = s.var_ids_.try_emplace(sym, 0);
+            if (res.second) {
+                res.first->second = s.difference_.add_node() | NODE_BIT;
+                if (sym.type() != Clingo::SymbolType::Number) {
+                    symbols.emplace_back(sym, res.first->second);
+                }
+            }
+            id = res.first->second;
+        }
+        assert(is_node_(id));
+        return id & ~NODE_BIT;
+    }
+
+    //! Add a row with a fresh basic variable to the tableau.
+    //!
+    //! The coefficients of the row are multiplied with the given scale.
+    //! Terms with basic variables are replaced by their rows in the tableau.
+    index_t add_row(Solver &s, Problem const &problem, Problem::Entry const *ib, Problem::Entry const *ie, Number const &scale) {
+        for (auto const *it = ib; it != ie; ++it) {
+            static_cast<void>(add_var(s, problem, it->var));
+        }
+        auto i = static_cast<index_t>(n_basic + basic.size());
+        auto original_i = static_cast<index_t>(s.original_basic_.size() + basic.size());
+        auto id = s.add_var_();
+        s.variables_[id].original_row = original_i;
+        basic.emplace_back(id);
+        Value value{0};
+        for (auto const *it = ib; it != ie; ++it) {
+            auto var = ids[it->var];
+            Number a = problem.number(it->co) * scale;
+            s.original_tableau_.set(original_i, original_cols[var], a);
+            value += a * s.values_[var];
+            if (var >= n_old()) {
+                row.emplace_back(n_non_basic + original_cols[var] - s.original_non_basic_.size(), a);
                 continue;
             }
-            if (auto [it, res] = cos.emplace(y.var, y.co); !res) {
-                it->second += y.co;
-                if (it->second == 0) {
-                    cos.erase(it);
+            auto j = s.variables_[var].reserve_index;
+            if (j < n_non_basic) {
+                // the columns of variables fixed on the top level have been
+                // removed and their constant contributions are only part of
+                // the value
+                if (!s.variables_[var].removed) {
+                    row.emplace_back(j, a);
                 }
             }
             else {
-                vars.emplace_back(y.var);
+                s.tableau_.for_row(j - n_non_basic, [&](index_t k, Number const &a_k) {
+                    row.emplace_back(k, a * a_k);
+                });
             }
         }
-
-        // add non-basic variables for the remaining non-zero coefficients
-        for (auto &var : vars) {
-            if (auto it = cos.find(var); it != cos.end()) {
-                index_t j = add_non_basic(s, var);
-                row.emplace_back(j, it->second);
+        // combine the coefficients of duplicate columns
+        std::sort(row.begin(), row.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+        for (auto it = row.begin(), ie = row.end(); it != ie;) {
+            auto j = it->first;
+            Number a = std::move(it->second);
+            for (++it; it != ie && it->first == j; ++it) {
+                a += it->second;
+            }
+            if (a != 0) {
+                s.tableau_.set(i, j, a);
             }
         }
-
-        return row;
+        row.clear();
+        s.values_[id] = std::move(value);
+        return id;
     }
 
-    void finish(Solver &s) {
-        s.n_basic_ = basic.size();
-        int i = s.n_non_basic_;
-        for (auto &index : basic) {
-            s.variables_[index].reserve_index = i;
-            s.variables_[i].index = index;
-            ++i;
+    //! Assign positions to the new variables.
+    //!
+    //! New non-basic variables are appended to the columns, which shifts the
+    //! positions of all basic variables.
+    void finish(Solver &s, Problem const &problem) {
+        s.col_vars_.insert(s.col_vars_.end(), non_basic.begin(), non_basic.end());
+        s.row_vars_.insert(s.row_vars_.end(), basic.begin(), basic.end());
+        s.n_non_basic_ += static_cast<index_t>(non_basic.size());
+        s.n_basic_ += static_cast<index_t>(basic.size());
+        for (index_t j = n_non_basic; j < s.n_non_basic_; ++j) {
+            s.variables_[s.col_vars_[j]].reserve_index = j;
+        }
+        for (index_t i = 0; i < s.n_basic_; ++i) {
+            s.variables_[s.row_vars_[i]].reserve_index = s.n_non_basic_ + i;
+        }
+
+        s.original_non_basic_.insert(s.original_non_basic_.end(), non_basic.begin(), non_basic.end());
+        s.original_basic_.insert(s.original_basic_.end(), basic.begin(), basic.end());
+
+        // keep the variables sorted for reporting assignments
+        for (uint32_t var = 0, e = problem.num_vars(); var != e; ++var) {
+            auto sym = problem.var(var);
+            if (ids[var] == std::numeric_limits<index_t>::max() && sym.type() != Clingo::SymbolType::Number) {
+                symbols.emplace_back(sym, std::numeric_limits<index_t>::max());
+            }
         }
+        std::sort(symbols.begin(), symbols.end());
+        auto mid = s.assignment_.insert(s.assignment_.end(), symbols.begin(), symbols.end());
+        std::inplace_merge(s.assignment_.begin(), mid, s.assignment_.end());
+        // drop variables without index that have been added to the tableau
+        s.assignment_.erase(std::unique(s.assignment_.begin(), s.assignment_.end(), [](auto const &a, auto const &b) {
+            return a.first == b.first;
+        }), s.assignment_.end());
     }
 
-    index_t n_vars{0};
+    //! The number of variables before preparation.
+    [[nodiscard]] index_t n_old() const {
+        return n_non_basic + n_basic;
+    }
+
+    //! Mapping from variable ids of the problem to solver variables.
+    std::vector<index_t> ids;
+    //! The number of non-basic variables before preparation.
+    index_t n_non_basic;
+    //! The number of basic variables before preparation.
+    index_t n_basic;
+    //! Mapping from solver variables to columns of the original tableau.
+    std::vector<index_t> original_cols;
+    //! The new non-basic variables.
+    std::vector<index_t> non_basic;
+    //! The new basic variables.
     std::vector<index_t> basic;
+    //! The symbols of the new variables.
+    std::vector<std::pair<Clingo::Symbol, index_t>> symbols;
+    //! Buffer to collect the coefficients of a row.
+    std::vector<std::pair<index_t, Number>> row;
 };
 
 template<typename Factor, typename Value>
@@ -132,13 +415,7 @@ template<typename Factor, typename Value>
 bool Solver<Factor, Value>::Variable::update_lower(Solver &s, Clingo::Assignment ass, Bound const &bound) {
     if (!has_lower() || bound.value > lower()) {
         if (!has_lower() || ass.level(lower_bound->lit) < ass.decision_level()) {
-            if (upper_bound != &bound) {
-                s.bound_trail_.emplace_back(bound.variable, BoundRelation::GreaterEqual, lower_bound);
-            }
-            else {
-                // Note: this assumes that update_lower is called right after update_upper for the same bound
-                std::get<1>(s.bound_trail_.back()) = BoundRelation::Equal;
-            }
+            s.bound_trail_.emplace_back(bound.variable, BoundRelation::GreaterEqual, lower_bound);
         }
         lower_bound = &bound;
     }
@@ -161,69 +438,214 @@ bool Solver<Factor, Value>::Variable::update(Solver &s, Clingo::Assignment ass,
     return update_upper(s, ass, bound) && update_lower(s, ass, bound);
 }
 
-template<typename Factor, typename Value>
-void Solver<Factor, Value>::Variable::set_value(Solver &s, index_t lvl, Value const &val, bool add) {
-    // We can always assume that the assignment on a previous level was satisfying.
-    // Thus, we simply store the old values to be able to restore them when backtracking.
-    if (lvl != level) {
-        s.assignment_trail_.emplace_back(level, this - s.variables_.data(), value);
-        level = lvl;
-    }
-    if (add) {
-        value += val;
+
+bool parse_show_values(char const *value, Options &options) {
+    options.show_values = true;
+    if (std::strcmp(value, "all") == 0) {
+        options.show_signatures.clear();
+        return true;
     }
-    else {
-        value = val;
+    for (char const *it = value;; ++it) {
+        auto const *sep = std::strchr(it, ',');
+        std::string sig = sep != nullptr ? std::string{it, sep} : std::string{it};
+        auto slash = sig.rfind('/');
+        if (slash == std::string::npos || slash + 1 == sig.size() || std::isdigit(static_cast<unsigned char>(sig[slash + 1])) == 0) {
+            return false;
+        }
+        char *end = nullptr;
+        auto arity = std::strtoul(sig.c_str() + slash + 1, &end, 10);
+        if (*end != '\0') {
+            return false;
+        }
+        options.show_signatures.emplace_back(sig.substr(0, slash), static_cast<unsigned>(arity));
+        if (sep == nullptr) {
+            return true;
+        }
+        it = sep;
     }
 }
 
-template<typename Factor, typename Value>
-bool Solver<Factor, Value>::Variable::has_conflict() const {
-    return (has_lower() && value < lower()) || (has_upper() && value > upper());
+size_t Memory::total() const {
+    return tableau + original_tableau + difference + bound_trail + assignment_trail + bounds + variables;
+}
+
+void Memory::add(Memory const &mem) {
+    tableau += mem.tableau;
+    original_tableau += mem.original_tableau;
+    difference += mem.difference;
+    bound_trail += mem.bound_trail;
+    assignment_trail += mem.assignment_trail;
+    bounds += mem.bounds;
+    variables += mem.variables;
+}
+
+void Memory::update_peak(Memory const &mem) {
+    tableau = std::max(tableau, mem.tableau);
+    original_tableau = std::max(original_tableau, mem.original_tableau);
+    difference = std::max(difference, mem.difference);
+    bound_trail = std::max(bound_trail, mem.bound_trail);
+    assignment_trail = std::max(assignment_trail, mem.assignment_trail);
+    bounds = std::max(bounds, mem.bounds);
+    variables = std::max(variables, mem.variables);
 }
 
 void Statistics::reset() {
     *this = {};
 }
 
+template<typename Factor, typename Value>
+Solver<Factor, Value>::Solver(Options const &options)
+: options_{options} { }
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::sample_memory() {
+    auto &mem = statistics_.memory_;
+    mem.tableau = tableau_.bytes();
+    mem.original_tableau = original_tableau_.bytes() +
+                           (original_basic_.capacity() + original_non_basic_.capacity()) * sizeof(index_t);
+    mem.difference = difference_.bytes();
+    mem.bound_trail = bound_trail_.capacity() * sizeof(typename decltype(bound_trail_)::value_type);
+    mem.assignment_trail = assignment_trail_.bytes();
+    // Note: the size of hash table nodes is estimated because it depends on
+    // the standard library implementation.
+    mem.bounds = bounds_.bucket_count() * sizeof(void*) + bounds_.size() * (sizeof(typename decltype(bounds_)::value_type) + 2 * sizeof(void*));
+    for (auto const &[lit, bound] : bounds_) {
+        mem.bounds += dynamic_bytes(bound.value);
+    }
+    mem.variables = variables_.capacity() * sizeof(Variable) +
+                    values_.capacity() * sizeof(Value) +
+                    (levels_.capacity() + row_vars_.capacity() + col_vars_.capacity()) * sizeof(index_t);
+    for (auto const &value : values_) {
+        mem.variables += dynamic_bytes(value);
+    }
+    statistics_.memory_peak_.update_peak(mem);
+    statistics_.memory_peak_total_ = std::max(statistics_.memory_peak_total_, mem.total());
+    statistics_.memory_sampled_ = statistics_.pivots_;
+    statistics_.memory_sampled_bound_trail_ = bound_trail_.capacity();
+    statistics_.memory_sampled_assignment_trail_ = assignment_trail_.capacity();
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::should_sample_memory_() const {
+    return statistics_.pivots_ - statistics_.memory_sampled_ >= MEMORY_SAMPLE_INTERVAL ||
+           bound_trail_.capacity() > statistics_.memory_sampled_bound_trail_ ||
+           assignment_trail_.capacity() > statistics_.memory_sampled_assignment_trail_;
+}
+
 template<typename Factor, typename Value>
 typename Solver<Factor, Value>::Variable &Solver<Factor, Value>::basic_(index_t i) {
     assert(i < n_basic_);
-    return variables_[variables_[i + n_non_basic_].index];
+    return variables_[row_vars_[i]];
 }
 
 template<typename Factor, typename Value>
 typename Solver<Factor, Value>::Variable &Solver<Factor, Value>::non_basic_(index_t j) {
     assert(j < n_non_basic_);
-    return variables_[variables_[j].index];
+    return variables_[col_vars_[j]];
+}
+
+template<typename Factor, typename Value>
+index_t Solver<Factor, Value>::add_var_() {
+    auto var = static_cast<index_t>(variables_.size());
+    variables_.emplace_back();
+    values_.emplace_back(0);
+    levels_.emplace_back(0);
+    conflicts_.resize(variables_.size());
+    return var;
+}
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::set_value_(index_t var, index_t level, Value const &val, bool add) {
+    // We can always assume that the assignment on a previous level was satisfying.
+    // Thus, we simply store the old values to be able to restore them when backtracking.
+    auto &value = values_[var];
+    if (level != levels_[var]) {
+        // The old value is moved to the trail by swapping if it is
+        // overwritten anyway. Either way, the storage of pooled trail entries
+        // is reused instead of allocating new values.
+        auto &old = assignment_trail_.push(levels_[var], var);
+        if (add) {
+            old = value;
+        }
+        else {
+            old.swap(value);
+        }
+        levels_[var] = level;
+    }
+    if (add) {
+        value += val;
+    }
+    else {
+        value = val;
+    }
 }
 
 template<typename Factor, typename Value>
 void Solver<Factor, Value>::enqueue_(index_t i) {
     assert(i < n_basic_);
-    auto ii = variables_[i + n_non_basic_].index;
+    auto ii = row_vars_[i];
     auto &xi = variables_[ii];
-    if (!xi.queued && xi.has_conflict()) {
-        conflicts_.emplace(ii);
-        xi.queued = true;
+    auto const &value = values_[ii];
+    if (!conflicts_.contains(ii) && ((xi.has_lower() && value < xi.lower()) || (xi.has_upper() && value > xi.upper()))) {
+        conflicts_.insert(ii);
     }
 }
 
 template<typename Factor, typename Value>
-bool Solver<Factor, Value>::prepare(Clingo::PropagateInit &init, std::vector<Inequality> &&inequalities) {
+Value Solver<Factor, Value>::slack_value_(Variable const &x) const {
+    // the variables in the original tableau are never inactive
+    Value ret{0};
+    original_tableau_.for_row(x.original_row, [&](index_t j, Number const &a_ij) {
+        ret += values_[original_non_basic_[j]] * a_ij;
+    });
+    return ret;
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::prepare(Clingo::PropagateInit &init, Problem const &problem) {
+    return prepare(init, problem, options_.reorder ? problem.bandwidth_order() : std::vector<size_t>{});
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::prepare(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order) {
     tableau_.clear();
+    original_tableau_.clear();
     variables_.clear();
-    indices_.clear();
+    values_.clear();
+    levels_.clear();
+    row_vars_.clear();
+    col_vars_.clear();
+    slacks_.clear();
+    bounds_.clear();
+    bound_trail_.clear();
+    assignment_trail_.clear();
+    trail_offset_.clear();
+    conflicts_.clear();
+    original_basic_.clear();
+    original_non_basic_.clear();
+    assignment_.clear();
+    var_ids_.clear();
+    difference_.clear();
+    use_difference_ = options_.difference_logic && options_.save_snapshot.empty() && options_.load_basis.empty();
     statistics_.reset();
+#ifdef CLINGOLPX_PERF
+    perf_.reset();
+#endif
     n_basic_ = 0;
     n_non_basic_ = 0;
 
-    inequalities_ = std::move(inequalities);
-    for (auto &x : inequalities_) {
-        x.lit = init.solver_literal(x.lit);
-        init.add_watch(x.lit);
-    }
+    // The solver numbers variables in order of their first occurrence in the
+    // rows, which places rows sharing variables next to each other.
+    return extend_(init, problem, order);
+}
 
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::extend(Clingo::PropagateInit &init, Problem const &problem) {
+    return extend_(init, problem, {});
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::extend_(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order) {
     // TODO: Bounds associated with a variable form a propagation chain. We can
     // add binary clauses to propagate them. For example
     //
@@ -237,78 +659,74 @@ bool Solver<Factor, Value>::prepare(Clingo::PropagateInit &init, std::vector<Ine
 
     auto ass = init.assignment();
 
-    Prepare prep;
-    for (auto const &x : inequalities_) {
-        if (ass.is_false(x.lit)) {
+    std::vector<bool> difference;
+    if (use_difference_) {
+        difference = difference_vars_(problem);
+    }
+
+    Prepare prep{*this, problem};
+    for (size_t n = 0, e = problem.size(); n != e; ++n) {
+        auto k = order.empty() ? n : order[n];
+        auto lit = init.solver_literal(problem.lit(k));
+        init.add_watch(lit);
+        if (ass.is_false(lit)) {
             continue;
         }
 
-        // transform inequality into row suitable for tableau
-        auto row = prep.add_row(*this, x);
+        auto rel = problem.rel(k);
+        auto rhs = problem.number(problem.rhs(k));
+        auto const *ib = problem.begin(k);
+        auto const *ie = problem.end(k);
 
         // check bound against 0
-        if (row.empty()) {
-            switch (x.rel) {
-                case Relation::Less: {
-                    if (x.rhs >= 0 && !init.add_clause({-x.lit})) {
-                        return false;
-                    }
-                    break;
-                }
-                case Relation::LessEqual: {
-                    if (x.rhs > 0 && !init.add_clause({-x.lit})) {
-                        return false;
-                    }
-                    break;
-                }
-                case Relation::Greater: {
-                    if (x.rhs <= 0 && !init.add_clause({-x.lit})) {
-                        return false;
-                    }
-                    break;
-                }
-                case Relation::GreaterEqual: {
-                    if (x.rhs < 0 && !init.add_clause({-x.lit})) {
-                        return false;
-                    }
-                    break;
-                }
-                case Relation::Equal: {
-                    if (x.rhs != 0 && !init.add_clause({-x.lit})) {
-                        return false;
-                    }
-                    break;
-                }
+        if (ib == ie) {
+            if (!holds_zero(rel, rhs) && !init.add_clause({-lit})) {
+                return false;
             }
         }
-        // add a bound to a non-basic variable
-        else if (row.size() == 1) {
-            auto const &[j, v] = row.front();
-            auto &xj = non_basic_(j);
-            auto rel = v < 0 ? invert(x.rel) : x.rel;
-            bounds_.emplace(x.lit, Bound{
-                bound_val<Value>(Factor{x.rhs / v}, rel),
-                variables_[j].index,
-                x.lit,
-                bound_rel<Factor, Value>(rel)});
+        // add a bound to a node of the difference logic engine
+        else if (ib + 1 == ie && !difference.empty() && difference[ib->var]) {
+            auto x = prep.add_node(*this, problem, ib->var);
+            auto v = problem.number(ib->co);
+            auto brel = v < 0 ? invert(rel) : rel;
+            add_difference_(lit, x, 0, bound_val<Value>(Factor{rhs / v}, brel), bound_rel<Factor, Value>(brel));
+        }
+        // add a bound to a variable
+        else if (ib + 1 == ie) {
+            auto var = prep.add_var(*this, problem, ib->var);
+            auto v = problem.number(ib->co);
+            auto brel = v < 0 ? invert(rel) : rel;
+            bounds_.emplace(lit, Bound{
+                bound_val<Value>(Factor{rhs / v}, brel),
+                var,
+                lit,
+                bound_rel<Factor, Value>(brel)});
+        }
+        // add a difference constraint
+        else if (!difference.empty() && difference[ib->var]) {
+            assert(ib + 2 == ie);
+            auto x = prep.add_node(*this, problem, ib->var);
+            auto y = prep.add_node(*this, problem, (ib + 1)->var);
+            auto v = problem.number(ib->co);
+            auto brel = v < 0 ? invert(rel) : rel;
+            add_difference_(lit, x, y, bound_val<Value>(Factor{rhs / v}, brel), bound_rel<Factor, Value>(brel));
         }
-        // add an inequality
+        // add an inequality scaled to integral coefficients, which keeps
+        // the coefficients small while pivoting
         else {
-            auto i = prep.add_basic(*this);
-            bounds_.emplace(x.lit, Bound{
-                bound_val<Value>(Factor{x.rhs}, x.rel),
-                static_cast<index_t>(variables_.size() - 1),
-                x.lit,
-                bound_rel<Factor, Value>(x.rel)});
-            for (auto const &[j, v] : row) {
-                tableau_.set(i, j, v);
-            }
+            auto scale = row_scale(problem, ib, ie);
+            auto var = prep.add_row(*this, problem, ib, ie, scale);
+            bounds_.emplace(lit, Bound{
+                bound_val<Value>(Factor{rhs * scale}, rel),
+                var,
+                lit,
+                bound_rel<Factor, Value>(rel)});
         }
     }
 
-    prep.finish(*this);
+    prep.finish(*this, problem);
 
-    for (size_t i = 0; i < n_basic_; ++i) {
+    for (index_t i = prep.n_basic; i < n_basic_; ++i) {
         enqueue_(i);
     }
 
@@ -316,55 +734,137 @@ bool Solver<Factor, Value>::prepare(Clingo::PropagateInit &init, std::vector<Ine
     assert_extra(check_basic_());
     assert_extra(check_non_basic_());
 
+    sample_memory();
+
     return true;
 }
 
 template<typename Factor, typename Value>
-std::vector<std::pair<Clingo::Symbol, Value>> Solver<Factor, Value>::assignment() const {
-    std::vector<std::pair<Clingo::Symbol, Value>> ret;
-    index_t k{0};
-    for (auto var : vars_()) {
-        if (auto it = indices_.find(var); it != indices_.end()) {
-            ret.emplace_back(var, variables_[it->second].value);
+bool Solver<Factor, Value>::can_extend(Problem const &problem) const {
+    if (!use_difference_) {
+        return true;
+    }
+    auto difference = difference_vars_(problem);
+    for (uint32_t var = 0, e = problem.num_vars(); var != e; ++var) {
+        if (!difference[var]) {
+            auto it = var_ids_.find(problem.var(var));
+            if (it != var_ids_.end() && is_node_(it->second)) {
+                return false;
+            }
         }
-        else {
-            ret.emplace_back(var, 0);
+    }
+    return true;
+}
+
+template<typename Factor, typename Value>
+std::vector<bool> Solver<Factor, Value>::difference_vars_(Problem const &problem) const {
+    // union-find over the variables of the problem where the root of each
+    // component records whether the component contains other rows
+    auto n = problem.num_vars();
+    std::vector<uint32_t> parent(n);
+    std::vector<bool> general(n, false);
+    for (uint32_t var = 0; var != n; ++var) {
+        parent[var] = var;
+        auto it = var_ids_.find(problem.var(var));
+        general[var] = it != var_ids_.end() && !is_node_(it->second);
+    }
+    auto find = [&parent](uint32_t var) {
+        while (parent[var] != var) {
+            parent[var] = parent[parent[var]];
+            var = parent[var];
+        }
+        return var;
+    };
+    for (size_t k = 0, e = problem.size(); k != e; ++k) {
+        auto const *ib = problem.begin(k);
+        auto const *ie = problem.end(k);
+        if (ie - ib < 2) {
+            continue;
+        }
+        auto root = find(ib->var);
+        for (auto const *it = ib + 1; it != ie; ++it) {
+            auto other = find(it->var);
+            if (other != root) {
+                parent[other] = root;
+                general[root] = general[root] || general[other];
+            }
+        }
+        if (ib + 2 != ie || problem.number(ib->co) != -problem.number((ib + 1)->co)) {
+            general[root] = true;
         }
     }
-    return ret;
+    std::vector<bool> difference(n);
+    for (uint32_t var = 0; var != n; ++var) {
+        difference[var] = !general[find(var)];
+    }
+    return difference;
+}
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::add_difference_(Clingo::literal_t lit, index_t x, index_t y, Value k, BoundRelation rel) {
+    if (rel != BoundRelation::LessEqual) {
+        // x - y >= k is equivalent to y - x <= -k
+        Value neg{0};
+        neg -= k;
+        difference_.add_edge(lit, x, y, std::move(neg));
+    }
+    if (rel != BoundRelation::GreaterEqual) {
+        difference_.add_edge(lit, y, x, std::move(k));
+    }
 }
 
 template<typename Factor, typename Value>
-bool Solver<Factor, Value>::solve(Clingo::PropagateControl &ctl, Clingo::LiteralSpan lits) {
+bool Solver<Factor, Value>::solve(Clingo::Assignment ass, Clingo::LiteralSpan lits) {
     index_t i{0};
     index_t j{0};
     Value const *v{nullptr};
 
-    auto ass = ctl.assignment();
     auto level = ass.decision_level();
 
+    perf_scope(perf_, PerfPhase::Solve);
+    trace_event(trace_, TraceEvent::PropagateBegin);
+
     if (trail_offset_.empty() || trail_offset_.back().level < level) {
         trail_offset_.emplace_back(TrailOffset{
             ass.decision_level(),
             static_cast<index_t>(bound_trail_.size()),
-            static_cast<index_t>(assignment_trail_.size())});
+            static_cast<index_t>(assignment_trail_.size()),
+            static_cast<index_t>(difference_.trail_size())});
     }
 
     for (auto lit : lits) {
+        if (use_difference_ && !difference_.activate(lit)) {
+            conflict_clause_.clear();
+            for (auto reason : difference_.reason()) {
+                conflict_clause_.emplace_back(-reason);
+            }
+            trace_event(trace_, TraceEvent::Conflict, conflict_clause_.size());
+            trace_event(trace_, TraceEvent::PropagateEnd);
+            return false;
+        }
         for (auto it = bounds_.find(lit), ie = bounds_.end(); it != ie && it->first == lit; ++it) {
             auto const &[lit, bound] = *it;
             auto &x = variables_[bound.variable];
-            if (!x.update(*this, ctl.assignment(), bound)) {
+            auto const &value = values_[bound.variable];
+            // the value of an inactive basic variable is brought up to date
+            // once it obtains its first bound
+            bool activate = x.reserve_index >= n_non_basic_ && x.is_inactive();
+            if (!x.update(*this, ass, bound)) {
                 conflict_clause_.clear();
                 conflict_clause_.emplace_back(-x.upper_bound->lit);
                 conflict_clause_.emplace_back(-x.lower_bound->lit);
+                trace_event(trace_, TraceEvent::Conflict, conflict_clause_.size());
+                trace_event(trace_, TraceEvent::PropagateEnd);
                 return false;
             }
+            if (activate) {
+                set_value_(bound.variable, level, slack_value_(x), false);
+            }
             if (x.reserve_index < n_non_basic_) {
-                if (x.has_lower() && x.value < x.lower()) {
+                if (x.has_lower() && value < x.lower()) {
                     update_(level, x.reserve_index, x.lower());
                 }
-                else if (x.has_upper() && x.value > x.upper()) {
+                else if (x.has_upper() && value > x.upper()) {
                     update_(level, x.reserve_index, x.upper());
                 }
             }
@@ -374,6 +874,10 @@ bool Solver<Factor, Value>::solve(Clingo::PropagateControl &ctl, Clingo::Literal
         }
     }
 
+    if (should_sample_memory_()) {
+        sample_memory();
+    }
+
     assert_extra(check_tableau_());
     assert_extra(check_basic_());
     assert_extra(check_non_basic_());
@@ -383,7 +887,7 @@ bool Solver<Factor, Value>::solve(Clingo::PropagateControl &ctl, Clingo::Literal
             case State::Satisfiable: {
 #ifdef CLINGOLP_KEEP_SAT_ASSIGNMENT
                 for (auto &[level, index, number] : assignment_trail_) {
-                    variables_[index].level = 0;
+                    levels_[index] = 0;
                 }
                 for (auto it = trail_offset_.rbegin(), ie = trail_offset_.rend(); it != ie; ++it) {
                     if (it->assignment > 0) {
@@ -395,14 +899,26 @@ bool Solver<Factor, Value>::solve(Clingo::PropagateControl &ctl, Clingo::Literal
                 }
                 assignment_trail_.clear();
 #endif
+                if (level == 0 && options_.simplify) {
+                    simplify_(ass);
+                }
+                trace_event(trace_, TraceEvent::PropagateEnd);
                 return true;
             }
             case State::Unsatisfiable: {
+                trace_event(trace_, TraceEvent::Conflict, conflict_clause_.size());
+                trace_event(trace_, TraceEvent::PropagateEnd);
                 return false;
             }
             case State::Unknown: {
                 assert(v != nullptr);
                 pivot_(level, i, j, *v);
+                // Note: memory is sampled periodically and whenever the
+                // trails grow because sampling is linear in the size of the
+                // tableau and trails.
+                if (should_sample_memory_()) {
+                    sample_memory();
+                }
             }
         }
     }
@@ -413,6 +929,13 @@ void Solver<Factor, Value>::undo() {
     // this function restores the last satisfying assignment
     auto &offset = trail_offset_.back();
 
+    perf_scope(perf_, PerfPhase::Undo);
+    trace_event(trace_, TraceEvent::Undo,
+                bound_trail_.size() - offset.bound,
+                assignment_trail_.size() - offset.assignment,
+                offset.bound,
+                offset.assignment);
+
     // undo bound updates
     for (auto it = bound_trail_.begin() + offset.bound, ie = bound_trail_.end(); it != ie; ++it) {
         auto [var, rel, bound] = *it;
@@ -437,15 +960,31 @@ void Solver<Factor, Value>::undo() {
     // undo assignments
     for (auto it = assignment_trail_.begin() + offset.assignment, ie = assignment_trail_.end(); it != ie; ++it) {
         auto &[level, index, number] = *it;
-        variables_[index].level = level;
-        variables_[index].value.swap(number);
+        levels_[index] = level;
+        values_[index].swap(number);
     }
-    assignment_trail_.resize(offset.assignment);
+    assignment_trail_.shrink(offset.assignment);
+
+    // The values of slack variables that were inactive on a lower level have
+    // not been recorded on the trail. Variables that became basic again are
+    // dropped from the list and only listed again once they leave the basis.
+    slacks_.erase(std::remove_if(slacks_.begin(), slacks_.end(), [this](index_t var) {
+        auto &x = variables_[var];
+        if (x.reserve_index >= n_non_basic_) {
+            x.listed = false;
+            return true;
+        }
+        if (x.is_inactive()) {
+            values_[var] = slack_value_(x);
+        }
+        return false;
+    }), slacks_.end());
+
+    // deactivate difference constraints
+    difference_.backtrack(offset.edge);
 
     // empty queue
-    for (; !conflicts_.empty(); conflicts_.pop()) {
-        variables_[conflicts_.top()].queued = false;
-    }
+    conflicts_.clear();
 
     trail_offset_.pop_back();
 
@@ -458,122 +997,604 @@ Statistics const &Solver<Factor, Value>::statistics() const {
 }
 
 template<typename Factor, typename Value>
-std::vector<Clingo::Symbol> Solver<Factor, Value>::vars_() const {
-    std::unordered_set<Clingo::Symbol> var_set;
-    for (auto const &x : inequalities_) {
-        for (auto const &y : x.lhs) {
-            if (y.var.type() != Clingo::SymbolType::Number) {
-                var_set.emplace(y.var);
+std::vector<std::string> Solver<Factor, Value>::export_names_() const {
+    std::vector<std::string> names(variables_.size());
+    for (auto const &[var, index] : assignment_) {
+        if (index < names.size()) {
+            auto name = var.to_string();
+            if (is_export_name(name)) {
+                names[index] = std::move(name);
             }
         }
     }
-    std::vector<Clingo::Symbol> var_vec{var_set.begin(), var_set.end()};
-    std::sort(var_vec.begin(), var_vec.end());
-    return var_vec;
-};
-
-template<typename Factor, typename Value>
-bool Solver<Factor, Value>::check_tableau_() {
-    for (index_t i{0}; i < n_basic_; ++i) {
-        Value v_i;
-        tableau_.update_row(i, [&](index_t j, Number const &a_ij){
-            v_i += non_basic_(j).value * a_ij;
+    for (index_t index = 0; index < names.size(); ++index) {
+        if (names[index].empty()) {
+            names[index] = "_v" + std::to_string(index);
+        }
+    }
+    // Slack variables are named after a hash of the terms of their rows,
+    // which keeps the names stable if rows are reordered or added in
+    // variations of a problem. Slack variables of rows with equal terms are
+    // numbered in order.
+    std::unordered_map<std::string, size_t> counts;
+    std::vector<std::pair<std::string, std::string>> terms;
+    for (index_t i = 0; i < original_basic_.size(); ++i) {
+        terms.clear();
+        original_tableau_.for_row(i, [&](index_t j, Number const &a) {
+            terms.emplace_back(names[original_non_basic_[j]], a.get_str());
         });
-        if (v_i != basic_(i).value) {
-            return false;
+        std::sort(terms.begin(), terms.end());
+        uint64_t hash = UINT64_C(0xcbf29ce484222325);
+        for (auto const &[name, co] : terms) {
+            hash = hash_string(hash, name + "*" + co + ";");
+        }
+        std::ostringstream oss;
+        oss << "_s" << std::hex << std::setw(16) << std::setfill('0') << hash;
+        auto name = oss.str();
+        auto n = counts[name]++;
+        if (n > 0) {
+            name += "_" + std::to_string(n);
         }
+        names[original_basic_[i]] = std::move(name);
     }
-    return true;
+    return names;
 }
 
 template<typename Factor, typename Value>
-bool Solver<Factor, Value>::check_basic_() {
-    for (index_t i = 0; i < n_basic_; ++i) {
-        auto &xi = basic_(i);
-        if (xi.has_lower() && xi.value < xi.lower() && !xi.queued) {
-            return false;
+void Solver<Factor, Value>::write_problem(std::ostream &out, bool mps) const {
+    struct Row {
+        std::string name;
+        std::vector<std::pair<index_t, Number>> terms;
+        Relation rel;
+        Number rhs;
+    };
+    auto names = export_names_();
+
+    // each row of the original tableau defines its basic variable
+    std::vector<Row> rows;
+    for (index_t i = 0; i < original_basic_.size(); ++i) {
+        Row row{"r" + std::to_string(i), {}, Relation::Equal, Number{0}};
+        original_tableau_.for_row(i, [&](index_t j, Number const &a) {
+            row.terms.emplace_back(original_non_basic_[j], a);
+        });
+        row.terms.emplace_back(original_basic_[i], Number{-1});
+        rows.emplace_back(std::move(row));
+    }
+
+    // each bound becomes a row named after its literal
+    std::vector<Bound const *> bounds;
+    bounds.reserve(bounds_.size());
+    for (auto const &[lit, bound] : bounds_) {
+        bounds.emplace_back(&bound);
+    }
+    std::sort(bounds.begin(), bounds.end(), [](Bound const *a, Bound const *b) {
+        if (a->lit != b->lit) {
+            return a->lit < b->lit;
         }
-        if (xi.has_upper() && xi.value > xi.upper() && !xi.queued) {
-            return false;
+        if (a->variable != b->variable) {
+            return a->variable < b->variable;
         }
+        if (a->rel != b->rel) {
+            return a->rel < b->rel;
+        }
+        return a->value < b->value;
+    });
+    for (size_t k = 0; k < bounds.size(); ++k) {
+        auto const &bound = *bounds[k];
+        auto rel = bound.rel == BoundRelation::LessEqual
+            ? Relation::LessEqual
+            : bound.rel == BoundRelation::GreaterEqual ? Relation::GreaterEqual : Relation::Equal;
+        auto name = "b" + std::to_string(k) +
+            (bound.lit > 0 ? "_p" : "_n") + std::to_string(std::abs(bound.lit)) +
+            (is_strict(bound.value) ? "_s" : "");
+        rows.emplace_back(Row{std::move(name), {{bound.variable, Number{1}}}, rel, rational_part(bound.value)});
     }
-    return true;
-}
 
-template<typename Factor, typename Value>
-bool Solver<Factor, Value>::check_non_basic_() {
-    for (index_t j = 0; j < n_non_basic_; ++j) {
-        auto &xj = non_basic_(j);
-        if (xj.has_lower() && xj.value < xj.lower()) {
-            return false;
+    // LP and MPS readers do not accept fractions, so each row is scaled by
+    // the least common multiple of its denominators
+    for (auto &row : rows) {
+        mpz_class den{row.rhs.get_den()};
+        for (auto const &[index, co] : row.terms) {
+            mpz_lcm(den.get_mpz_t(), den.get_mpz_t(), co.get_den_mpz_t());
         }
-        if (xj.has_upper() && xj.value > xj.upper()) {
-            return false;
+        if (den != 1) {
+            Number scale{den};
+            for (auto &[index, co] : row.terms) {
+                co *= scale;
+            }
+            row.rhs *= scale;
         }
     }
-    return true;
-}
 
-template<typename Factor, typename Value>
-bool Solver<Factor, Value>::check_solution_() {
-    for (auto &x : variables_) {
-        if (x.has_lower() && x.lower() > x.value) {
-            return false;
+    std::vector<index_t> columns{original_non_basic_};
+    columns.insert(columns.end(), original_basic_.begin(), original_basic_.end());
+
+    if (!mps) {
+        out << "\\ Problem prepared by clingo-lpx\n";
+        out << "\\ Rows b<k>_<p|n><lit> are bounds guarded by literal <lit>.\n";
+        out << "\\ Strict bounds have suffix _s and are written as non-strict bounds.\n";
+        out << "Minimize\n obj:\nSubject To\n";
+        for (auto const &row : rows) {
+            out << " " << row.name << ":";
+            size_t n = 0;
+            for (auto const &[index, co] : row.terms) {
+                if (n > 0 && n % LP_TERMS_PER_LINE == 0) {
+                    out << "\n   ";
+                }
+                out << (co < 0 ? " - " : n > 0 ? " + " : " ");
+                Number a = abs(co);
+                if (a != 1) {
+                    out << a << " ";
+                }
+                out << names[index];
+                ++n;
+            }
+            out << " " << row.rel << " " << row.rhs << "\n";
         }
-        if (x.has_upper() && x.value > x.upper()) {
-            return false;
+        out << "Bounds\n";
+        for (auto index : columns) {
+            out << " " << names[index] << " free\n";
         }
+        out << "End\n";
+        return;
     }
-    return check_tableau_() && check_basic_();
-}
 
-template<typename Factor, typename Value>
-void Solver<Factor, Value>::update_(index_t level, index_t j, Value v) {
-    auto &xj = non_basic_(j);
-    tableau_.update_col(j, [&](index_t i, Number const &a_ij) {
-        basic_(i).set_value(*this, level, a_ij * (v - xj.value), true);
+    out << "* Problem prepared by clingo-lpx\n";
+    out << "* Rows b<k>_<p|n><lit> are bounds guarded by literal <lit>.\n";
+    out << "* Strict bounds have suffix _s and are written as non-strict bounds.\n";
+    out << "NAME clingo-lpx\nROWS\n N obj\n";
+    std::vector<std::vector<std::pair<size_t, Number const *>>> entries(variables_.size());
+    for (size_t k = 0; k < rows.size(); ++k) {
+        auto const &row = rows[k];
+        out << (row.rel == Relation::LessEqual ? " L " : row.rel == Relation::GreaterEqual ? " G " : " E ") << row.name << "\n";
+        for (auto const &[index, co] : row.terms) {
+            entries[index].emplace_back(k, &co);
+        }
+    }
+    out << "COLUMNS\n";
+    for (auto index : columns) {
+        for (auto const &[k, co] : entries[index]) {
+            out << " " << names[index] << " " << rows[k].name << " " << *co << "\n";
+        }
+    }
+    out << "RHS\n";
+    for (auto const &row : rows) {
+        if (row.rhs != 0) {
+            out << " rhs " << row.name << " " << row.rhs << "\n";
+        }
+    }
+    out << "BOUNDS\n";
+    for (auto index : columns) {
+        out << " FR bnd " << names[index] << "\n";
+    }
+    out << "ENDATA\n";
+}
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::write_basis(std::ostream &out) const {
+    // Note: the logicals of the rows defining basic variables are nonbasic
+    // while the logicals of bound rows stay basic.
+    auto names = export_names_();
+    out << "NAME clingo-lpx\n";
+    for (index_t i = 0; i < n_basic_; ++i) {
+        out << " XL " << names[row_vars_[i]] << " r" << i << "\n";
+    }
+    out << "ENDATA\n";
+}
+
+template<typename Factor, typename Value>
+size_t Solver<Factor, Value>::warm_start(std::vector<std::string> const &basic) {
+    // Note: Right after preparation all variables have value zero and no
+    // bounds are active. Hence, the basis can be changed without adjusting
+    // the assignment.
+    auto names = export_names_();
+    std::unordered_map<std::string, index_t> ids;
+    for (index_t var = 0; var < names.size(); ++var) {
+        ids.emplace(std::move(names[var]), var);
+    }
+    std::vector<bool> target(variables_.size(), false);
+    std::vector<index_t> vars;
+    for (auto const &name : basic) {
+        auto it = ids.find(name);
+        if (it != ids.end() && !target[it->second]) {
+            target[it->second] = true;
+            vars.emplace_back(it->second);
+        }
+    }
+
+    size_t pivots = 0;
+    for (auto var : vars) {
+        auto j = variables_[var].reserve_index;
+        if (j >= n_non_basic_) {
+            continue;
+        }
+        // select a row whose basic variable is not part of the saved basis
+        auto i = n_basic_;
+        tableau_.update_col(j, [&](index_t k, Number const &a_kj) {
+            static_cast<void>(a_kj);
+            if (i == n_basic_ && !target[row_vars_[k]]) {
+                i = k;
+            }
+        });
+        if (i == n_basic_) {
+            continue;
+        }
+        auto &xi = basic_(i);
+        auto &xj = non_basic_(j);
+        std::swap(xi.reserve_index, xj.reserve_index);
+        std::swap(row_vars_[i], col_vars_[j]);
+        statistics_.fill_in_ += tableau_.pivot(i, j);
+        ++pivots;
+    }
+
+    assert_extra(check_tableau_());
+    assert_extra(check_basic_());
+    assert_extra(check_non_basic_());
+
+    return pivots;
+}
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::save_snapshot(Clingo::PropagateInit &init, Problem const &problem, SnapshotWriter &out) const {
+    if (use_difference_) {
+        throw std::runtime_error("snapshots require all rows in the tableau");
+    }
+    // map solver literals back to program literals and collect the literals
+    // of rows without variables that have been set to false
+    std::unordered_map<Clingo::literal_t, Clingo::literal_t> lits;
+    std::vector<Clingo::literal_t> units;
+    for (size_t k = 0, e = problem.size(); k != e; ++k) {
+        lits.emplace(init.solver_literal(problem.lit(k)), problem.lit(k));
+        if (problem.begin(k) == problem.end(k) && !holds_zero(problem.rel(k), problem.number(problem.rhs(k)))) {
+            units.emplace_back(problem.lit(k));
+        }
+    }
+
+    // initial basis
+    out.write_u64(n_non_basic_);
+    out.write_u64(n_basic_);
+    for (auto index : original_non_basic_) {
+        out.write_u32(index);
+    }
+    for (auto index : original_basic_) {
+        out.write_u32(index);
+    }
+
+    // tableau in CSR form
+    uint64_t offset = 0;
+    out.write_u64(offset);
+    for (index_t i = 0; i < n_basic_; ++i) {
+        original_tableau_.for_row(i, [&](index_t j, Number const &a) {
+            static_cast<void>(j);
+            static_cast<void>(a);
+            ++offset;
+        });
+        out.write_u64(offset);
+    }
+    for (index_t i = 0; i < n_basic_; ++i) {
+        original_tableau_.for_row(i, [&](index_t j, Number const &a) {
+            static_cast<void>(a);
+            out.write_u32(j);
+        });
+    }
+    for (index_t i = 0; i < n_basic_; ++i) {
+        original_tableau_.for_row(i, [&](index_t j, Number const &a) {
+            static_cast<void>(j);
+            out.write_number(a);
+        });
+    }
+
+    // bounds
+    out.write_u64(bounds_.size());
+    for (auto const &[lit, bound] : bounds_) {
+        out.write_i32(lits[lit]);
+        out.write_u32(bound.variable);
+        out.write_u32(static_cast<uint32_t>(bound.rel));
+        write_value(out, bound.value);
+    }
+    out.write_u64(units.size());
+    for (auto lit : units) {
+        out.write_i32(lit);
+    }
+
+    // symbols
+    out.write_u64(assignment_.size());
+    for (auto const &[var, index] : assignment_) {
+        out.write_string(var.to_string());
+        out.write_u32(index);
+    }
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::load_snapshot(Clingo::PropagateInit &init, SnapshotReader &in) {
+    tableau_.clear();
+    variables_.clear();
+    values_.clear();
+    levels_.clear();
+    row_vars_.clear();
+    col_vars_.clear();
+    slacks_.clear();
+    bounds_.clear();
+    bound_trail_.clear();
+    assignment_trail_.clear();
+    trail_offset_.clear();
+    conflicts_.clear();
+    var_ids_.clear();
+    difference_.clear();
+    use_difference_ = false;
+    statistics_.reset();
+#ifdef CLINGOLPX_PERF
+    perf_.reset();
+#endif
+
+    // initial basis
+    auto read_index = [&in](size_t n) {
+        auto index = in.read_u32();
+        if (index >= n) {
+            throw std::runtime_error("invalid snapshot");
+        }
+        return index;
+    };
+    // The basis lists hold a 32-bit index per variable, which bounds the
+    // number of variables before anything is allocated.
+    auto n_non_basic = in.read_u64();
+    auto n_basic = in.read_u64();
+    auto max_vars = std::min<uint64_t>(in.remaining() / sizeof(uint32_t), NODE_BIT - 1);
+    if (n_non_basic > max_vars || n_basic > max_vars - n_non_basic) {
+        throw std::runtime_error("invalid snapshot");
+    }
+    n_non_basic_ = static_cast<index_t>(n_non_basic);
+    n_basic_ = static_cast<index_t>(n_basic);
+    auto n = static_cast<size_t>(n_non_basic_) + n_basic_;
+    // each variable must be either basic or non-basic
+    std::vector<bool> seen(n, false);
+    auto read_var = [&read_index, &seen, n]() {
+        auto index = read_index(n);
+        if (seen[index]) {
+            throw std::runtime_error("invalid snapshot");
+        }
+        seen[index] = true;
+        return index;
+    };
+    original_non_basic_.clear();
+    original_basic_.clear();
+    for (index_t j = 0; j < n_non_basic_; ++j) {
+        original_non_basic_.emplace_back(read_var());
+    }
+    for (index_t i = 0; i < n_basic_; ++i) {
+        original_basic_.emplace_back(read_var());
+    }
+    variables_.resize(n);
+    values_.resize(n);
+    levels_.resize(n);
+    conflicts_.resize(n);
+    col_vars_ = original_non_basic_;
+    row_vars_ = original_basic_;
+    for (index_t j = 0; j < n_non_basic_; ++j) {
+        variables_[original_non_basic_[j]].reserve_index = j;
+    }
+    for (index_t i = 0; i < n_basic_; ++i) {
+        variables_[original_basic_[i]].reserve_index = n_non_basic_ + i;
+        variables_[original_basic_[i]].original_row = i;
+    }
+
+    // tableau in CSR form
+    std::vector<uint64_t> offsets;
+    offsets.reserve(n_basic_ + 1);
+    for (index_t i = 0; i <= n_basic_; ++i) {
+        offsets.emplace_back(in.read_u64());
+        if (i > 0 && offsets[i] < offsets[i - 1]) {
+            throw std::runtime_error("invalid snapshot");
+        }
+    }
+    if (offsets.front() != 0 || offsets.back() > in.remaining() / sizeof(uint32_t)) {
+        throw std::runtime_error("invalid snapshot");
+    }
+    std::vector<index_t> cols;
+    cols.reserve(offsets.back());
+    for (uint64_t k = 0; k < offsets.back(); ++k) {
+        cols.emplace_back(read_index(n_non_basic_));
+    }
+    for (index_t i = 0; i < n_basic_; ++i) {
+        for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+            tableau_.set(i, cols[k], in.read_number());
+        }
+    }
+
+    // bounds
+    auto ass = init.assignment();
+    for (auto m = in.read_u64(); m > 0; --m) {
+        auto lit = init.solver_literal(in.read_i32());
+        auto variable = read_index(n);
+        auto rel = in.read_u32();
+        if (rel > static_cast<uint32_t>(BoundRelation::Equal)) {
+            throw std::runtime_error("invalid snapshot");
+        }
+        auto value = read_value<Value>(in);
+        init.add_watch(lit);
+        if (!ass.is_false(lit)) {
+            bounds_.emplace(lit, Bound{std::move(value), variable, lit, static_cast<BoundRelation>(rel)});
+        }
+    }
+    for (auto m = in.read_u64(); m > 0; --m) {
+        if (!init.add_clause({-init.solver_literal(in.read_i32())})) {
+            return false;
+        }
+    }
+
+    // symbols
+    assignment_.clear();
+    for (auto m = in.read_u64(); m > 0; --m) {
+        auto var = Clingo::parse_term(in.read_string().c_str());
+        auto index = in.read_u32();
+        assignment_.emplace_back(var, index < n ? index : std::numeric_limits<index_t>::max());
+        if (index < n) {
+            var_ids_.emplace(var, index);
+        }
+    }
+
+    for (size_t i = 0; i < n_basic_; ++i) {
         enqueue_(i);
+    }
+    original_tableau_ = tableau_;
+
+    assert_extra(check_tableau_());
+    assert_extra(check_basic_());
+    assert_extra(check_non_basic_());
+
+    sample_memory();
+
+    return true;
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::check_tableau_() {
+    // the rows no longer contain the constant contributions of removed
+    // columns and the values are checked against the original tableau
+    // instead
+    if (statistics_.removed_columns_ > 0) {
+        for (index_t j = 0; j < n_non_basic_; ++j) {
+            bool empty = true;
+            if (non_basic_(j).removed) {
+                tableau_.update_col(j, [&empty](index_t, Number const &) { empty = false; });
+            }
+            if (!empty) {
+                return false;
+            }
+        }
+        for (auto var : original_basic_) {
+            auto const &x = variables_[var];
+            if (!(x.reserve_index >= n_non_basic_ && x.is_inactive()) && slack_value_(x) != values_[var]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (index_t i{0}; i < n_basic_; ++i) {
+        if (basic_(i).is_inactive()) {
+            continue;
+        }
+        Value v_i;
+        tableau_.update_row(i, [&](index_t j, Number const &a_ij){
+            v_i += values_[col_vars_[j]] * a_ij;
+        });
+        if (v_i != values_[row_vars_[i]]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::check_basic_() {
+    for (index_t i = 0; i < n_basic_; ++i) {
+        auto &xi = basic_(i);
+        auto const &value = values_[row_vars_[i]];
+        if (xi.has_lower() && value < xi.lower() && !conflicts_.contains(row_vars_[i])) {
+            return false;
+        }
+        if (xi.has_upper() && value > xi.upper() && !conflicts_.contains(row_vars_[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::check_non_basic_() {
+    for (index_t j = 0; j < n_non_basic_; ++j) {
+        auto &xj = non_basic_(j);
+        auto const &value = values_[col_vars_[j]];
+        if (xj.has_lower() && value < xj.lower()) {
+            return false;
+        }
+        if (xj.has_upper() && value > xj.upper()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::check_solution_() {
+    for (index_t var = 0; var < variables_.size(); ++var) {
+        auto &x = variables_[var];
+        if (x.has_lower() && x.lower() > values_[var]) {
+            return false;
+        }
+        if (x.has_upper() && values_[var] > x.upper()) {
+            return false;
+        }
+    }
+    return check_tableau_() && check_basic_();
+}
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::update_(index_t level, index_t j, Value v) {
+    auto jj = col_vars_[j];
+    tableau_.update_col(j, [&](index_t i, Number const &a_ij) {
+        auto ii = row_vars_[i];
+        if (!variables_[ii].is_inactive()) {
+            set_value_(ii, level, a_ij * (v - values_[jj]), true);
+            enqueue_(i);
+        }
     });
-    xj.set_value(*this, level, std::move(v), false);
+    set_value_(jj, level, v, false);
 }
 
 template<typename Factor, typename Value>
 void Solver<Factor, Value>::pivot_(index_t level, index_t i, index_t j, Value const &v) {
+    perf_scope(perf_, PerfPhase::Pivot);
+
     auto &a_ij = tableau_.unsafe_get(i, j);
     assert(a_ij != 0);
 
-    auto &xi = basic_(i);
-    auto &xj = non_basic_(j);
+    auto ii = row_vars_[i];
+    auto jj = col_vars_[j];
+    auto &xi = variables_[ii];
+    auto &xj = variables_[jj];
 
     // adjust assignment
-    Value dj = (v - xi.value) / a_ij;
+    Value dj = (v - values_[ii]) / a_ij;
     assert(dj != 0);
-    xi.set_value(*this, level, v, false);
-    xj.set_value(*this, level, dj, true);
+    set_value_(ii, level, v, false);
+    set_value_(jj, level, dj, true);
     // TODO: can this be merged into the loop below?:
     tableau_.update_col(j, [&](index_t k, Number const &a_kj) {
-        if (k != i) {
-            basic_(k).set_value(*this, level, a_kj * dj, true);
+        auto kk = row_vars_[k];
+        if (k != i && !variables_[kk].is_inactive()) {
+            set_value_(kk, level, a_kj * dj, true);
             enqueue_(k);
         }
     });
     assert_extra(check_tableau_());
 
+    if (xi.is_slack() && !xi.listed) {
+        slacks_.emplace_back(ii);
+        xi.listed = true;
+    }
+
     // swap variables x_i and x_j
     std::swap(xi.reserve_index, xj.reserve_index);
-    std::swap(variables_[i + n_non_basic_].index, variables_[j].index);
+    std::swap(row_vars_[i], col_vars_[j]);
     enqueue_(i);
 
-    // invert row i
-    tableau_.update_row(i, [&](index_t k, Number &a_ik) {
-        if (k != j) {
-            a_ik /= -a_ij;
-        }
+    // invert row i and eliminate x_j from rows k != i
+    int64_t fill_in{0};
+    {
+        perf_scope(perf_, PerfPhase::Eliminate);
+        fill_in = tableau_.pivot(i, j);
+    }
+    trace_event(trace_, TraceEvent::Pivot, i, j, fill_in);
+
+    // monitor the growth of coefficients
+    tableau_.update_row(i, [&](index_t, Number const &a_ik) {
+        auto num_bits = mpz_sizeinbase(a_ik.get_num_mpz_t(), 2);
+        auto den_bits = mpz_sizeinbase(a_ik.get_den_mpz_t(), 2);
+        statistics_.numerator_bits_ = std::max(statistics_.numerator_bits_, num_bits);
+        statistics_.denominator_bits_ = std::max(statistics_.denominator_bits_, den_bits);
     });
-    a_ij = 1 / a_ij;
-
-    // eliminate x_j from rows k != i
-    tableau_.eliminate(i, j);
+    statistics_.fill_in_ += fill_in;
 
     ++statistics_.pivots_;
     assert_extra(check_tableau_());
@@ -582,15 +1603,62 @@ void Solver<Factor, Value>::pivot_(index_t level, index_t i, index_t j, Value co
 }
 
 template<typename Factor, typename Value>
-bool Solver<Factor, Value>::select_(bool upper, Variable &x) {
+void Solver<Factor, Value>::simplify_(Clingo::Assignment ass) {
+    auto removed_rows = statistics_.removed_rows_;
+    auto removed_columns = statistics_.removed_columns_;
+    // the row of an inactive basic slack variable is never used again once
+    // the literal of its bound is false
+    for (auto const &[lit, bound] : bounds_) {
+        auto &x = variables_[bound.variable];
+        if (!x.removed && x.reserve_index >= n_non_basic_ && x.is_inactive() && ass.is_false(lit)) {
+            x.removed = true;
+            ++statistics_.removed_rows_;
+        }
+    }
+    // a fixed non-basic variable is never selected for pivoting
+    for (index_t j = 0; j < n_non_basic_; ++j) {
+        auto &xj = non_basic_(j);
+        if (!xj.removed && xj.has_lower() && xj.has_upper() && xj.lower() == xj.upper()) {
+            assert(values_[col_vars_[j]] == xj.lower());
+            xj.removed = true;
+            ++statistics_.removed_columns_;
+        }
+    }
+    if (removed_rows != statistics_.removed_rows_ || removed_columns != statistics_.removed_columns_) {
+        compact_();
+        tableau_.shrink();
+    }
+    assert_extra(check_tableau_());
+}
+
+template<typename Factor, typename Value>
+void Solver<Factor, Value>::compact_() {
+    if (statistics_.removed_rows_ == 0 && statistics_.removed_columns_ == 0) {
+        return;
+    }
+    for (index_t j = 0; j < n_non_basic_; ++j) {
+        if (non_basic_(j).removed) {
+            tableau_.clear_col(j);
+        }
+    }
+    for (index_t i = 0; i < n_basic_; ++i) {
+        if (basic_(i).removed) {
+            tableau_.clear_row(i);
+        }
+    }
+}
+
+template<typename Factor, typename Value>
+bool Solver<Factor, Value>::select_(bool upper, index_t var) {
+    auto const &x = variables_[var];
     if (upper) {
-        if (!x.has_upper() || x.value < x.upper()) {
+        if (!x.has_upper() || values_[var] < x.upper()) {
             return true;
         }
         conflict_clause_.emplace_back(-x.upper_bound->lit);
     }
     else {
-        if (!x.has_lower() || x.value > x.lower()) {
+        if (!x.has_lower() || values_[var] > x.lower()) {
             return true;
         }
         conflict_clause_.emplace_back(-x.lower_bound->lit);
@@ -603,25 +1671,26 @@ typename Solver<Factor, Value>::State Solver<Factor, Value>::select_(index_t &re
     // This implements Bland's rule selecting the variables with the smallest
     // indices for pivoting.
 
-    for (; !conflicts_.empty(); conflicts_.pop()) {
-        auto ii = conflicts_.top();
+    while (!conflicts_.empty()) {
+        auto ii = conflicts_.min();
+        conflicts_.erase(ii);
         auto &xi = variables_[ii];
         auto i = xi.reserve_index;
-        assert(ii == variables_[i].index);
-        xi.queued = false;
         // the queue might contain variables that meanwhile became basic
         if (i < n_non_basic_) {
             continue;
         }
         i -= n_non_basic_;
+        assert(ii == row_vars_[i]);
+        auto const &value = values_[ii];
 
-        if (xi.has_lower() && xi.value < xi.lower()) {
+        if (xi.has_lower() && value < xi.lower()) {
             conflict_clause_.clear();
             conflict_clause_.emplace_back(-xi.lower_bound->lit);
             index_t kk = variables_.size();
             tableau_.update_row(i, [&](index_t j, Number const &a_ij) {
-                auto jj = variables_[j].index;
-                if (jj < kk && select_(a_ij > 0, variables_[jj])) {
+                auto jj = col_vars_[j];
+                if (jj < kk && select_(a_ij > 0, jj)) {
                     kk = jj;
                     ret_i = i;
                     ret_j = j;
@@ -634,13 +1703,13 @@ typename Solver<Factor, Value>::State Solver<Factor, Value>::select_(index_t &re
             return State::Unknown;
         }
 
-        if (xi.has_upper() && xi.value > xi.upper()) {
+        if (xi.has_upper() && value > xi.upper()) {
             conflict_clause_.clear();
             conflict_clause_.emplace_back(-xi.upper_bound->lit);
             index_t kk = variables_.size();
             tableau_.update_row(i, [&](index_t j, Number const &a_ij) {
-                auto jj = variables_[j].index;
-                if (jj < kk && select_(a_ij < 0, variables_[jj])) {
+                auto jj = col_vars_[j];
+                if (jj < kk && select_(a_ij < 0, jj)) {
                     kk = jj;
                     ret_i = i;
                     ret_j = j;
@@ -659,15 +1728,489 @@ typename Solver<Factor, Value>::State Solver<Factor, Value>::select_(index_t &re
     return State::Satisfiable;
 }
 
+template<typename Factor, typename Value>
+Components<Factor, Value>::Components(Options const &options)
+: options_{options} { }
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::prepare(Clingo::PropagateInit &init, Problem const &problem) {
+    return prepare(init, problem, options_.reorder ? problem.bandwidth_order() : std::vector<size_t>{});
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::prepare(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order) {
+    solvers_.clear();
+    var_components_.clear();
+    lit_components_.clear();
+    lits_.clear();
+    touched_.clear();
+    levels_.clear();
+    memory_peak_total_ = 0;
+    decompose_ = options_.decompose && options_.save_snapshot.empty() && options_.load_basis.empty();
+    return extend_(init, problem, order);
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::partition_(Problem const &problem, std::vector<index_t> &rows, index_t &n) const {
+    static constexpr auto invalid = std::numeric_limits<index_t>::max();
+    n = static_cast<index_t>(solvers_.size());
+    rows.assign(problem.size(), 0);
+    if (!decompose_) {
+        n = std::max<index_t>(n, 1);
+        return true;
+    }
+    // union-find over the variables of the problem where the root of each
+    // component records the existing component it belongs to
+    auto n_vars = problem.num_vars();
+    std::vector<uint32_t> parent(n_vars);
+    std::vector<index_t> component(n_vars, invalid);
+    for (uint32_t var = 0; var != n_vars; ++var) {
+        parent[var] = var;
+        auto it = var_components_.find(problem.var(var));
+        if (it != var_components_.end()) {
+            component[var] = it->second;
+        }
+    }
+    auto find = [&parent](uint32_t var) {
+        while (parent[var] != var) {
+            parent[var] = parent[parent[var]];
+            var = parent[var];
+        }
+        return var;
+    };
+    for (size_t k = 0, e = problem.size(); k != e; ++k) {
+        auto const *ib = problem.begin(k);
+        auto const *ie = problem.end(k);
+        if (ib == ie) {
+            continue;
+        }
+        auto root = find(ib->var);
+        for (auto const *it = ib + 1; it != ie; ++it) {
+            auto other = find(it->var);
+            if (other == root) {
+                continue;
+            }
+            if (component[root] == invalid) {
+                component[root] = component[other];
+            }
+            else if (component[other] != invalid && component[other] != component[root]) {
+                return false;
+            }
+            parent[other] = root;
+        }
+    }
+    for (size_t k = 0, e = problem.size(); k != e; ++k) {
+        auto const *ib = problem.begin(k);
+        if (ib == problem.end(k)) {
+            n = std::max<index_t>(n, 1);
+            continue;
+        }
+        auto &comp = component[find(ib->var)];
+        if (comp == invalid) {
+            comp = n++;
+        }
+        rows[k] = comp;
+    }
+    return true;
+}
+
+template<typename Factor, typename Value>
+std::vector<Problem> Components<Factor, Value>::split_(Problem const &problem, std::vector<index_t> const &rows, index_t n, std::vector<size_t> const &order) {
+    std::vector<Problem> problems(n);
+    for (size_t m = 0, e = problem.size(); m != e; ++m) {
+        auto k = order.empty() ? m : order[m];
+        problems[rows[k]].append_row(problem, k);
+    }
+    return problems;
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::extend(Clingo::PropagateInit &init, Problem const &problem) {
+    return extend_(init, problem, {});
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::extend_(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order) {
+    std::vector<index_t> rows;
+    index_t n = 0;
+    if (!partition_(problem, rows, n)) {
+        throw std::logic_error("rows must not connect existing components");
+    }
+    if (decompose_) {
+        for (size_t k = 0, e = problem.size(); k != e; ++k) {
+            for (auto const *it = problem.begin(k), *ie = problem.end(k); it != ie; ++it) {
+                var_components_.try_emplace(problem.var(it->var), rows[k]);
+            }
+            auto lit = init.solver_literal(problem.lit(k));
+            auto range = lit_components_.equal_range(lit);
+            if (std::none_of(range.first, range.second, [&](auto const &x) { return x.second == rows[k]; })) {
+                lit_components_.emplace(lit, rows[k]);
+            }
+        }
+    }
+    if (n == 1 && solvers_.empty()) {
+        // avoid copying the problem if it forms a single component
+        solvers_.emplace_back(options_);
+        lits_.emplace_back();
+        assignment_.clear();
+        return solvers_.back().prepare(init, problem, order);
+    }
+    // the rows of the component problems are already in the given order
+    auto problems = split_(problem, rows, n, order);
+    for (index_t c = 0; c != n; ++c) {
+        if (c < solvers_.size()) {
+            if (problems[c].size() > 0 && !solvers_[c].extend(init, problems[c])) {
+                return false;
+            }
+            continue;
+        }
+        solvers_.emplace_back(options_);
+        lits_.emplace_back();
+        if (!solvers_.back().prepare(init, problems[c], {})) {
+            return false;
+        }
+    }
+    merge_assignment_();
+    return true;
+}
+
+template<typename Factor, typename Value>
+void Components<Factor, Value>::merge_assignment_() {
+    assignment_.clear();
+    if (solvers_.size() == 1) {
+        return;
+    }
+    // A variable occurring only with zero coefficients in the rows of one
+    // component might occur in the rows of another component. Such
+    // duplicates are dropped in favor of the component the variable occurs
+    // in.
+    std::vector<std::tuple<Clingo::Symbol, bool, index_t, index_t>> vars;
+    for (index_t comp = 0; comp != solvers_.size(); ++comp) {
+        auto const &slv = solvers_[comp];
+        for (index_t i = 0, e = slv.assignment_size(); i != e; ++i) {
+            vars.emplace_back(slv.assignment_symbol(i), !slv.assignment_known(i), comp, i);
+        }
+    }
+    std::sort(vars.begin(), vars.end());
+    assignment_.reserve(vars.size());
+    for (auto it = vars.begin(), ie = vars.end(); it != ie; ++it) {
+        if (it == vars.begin() || std::get<0>(*std::prev(it)) != std::get<0>(*it)) {
+            assignment_.emplace_back(std::get<2>(*it), std::get<3>(*it));
+        }
+    }
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::can_extend(Problem const &problem) const {
+    std::vector<index_t> rows;
+    index_t n = 0;
+    if (!partition_(problem, rows, n)) {
+        return false;
+    }
+    auto problems = split_(problem, rows, n, {});
+    for (index_t c = 0; c != n && c < solvers_.size(); ++c) {
+        if (problems[c].size() > 0 && !solvers_[c].can_extend(problems[c])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::solve(Clingo::PropagateControl &ctl, Clingo::LiteralSpan lits) {
+    auto ass = ctl.assignment();
+    auto level = ass.decision_level();
+    if (levels_.empty() || levels_.back().first < level) {
+        levels_.emplace_back(level, std::vector<index_t>{});
+    }
+    auto &solved = levels_.back().second;
+    reasons_.clear();
+
+    if (solvers_.size() == 1) {
+        if (solved.empty()) {
+            solved.emplace_back(0);
+        }
+        if (!solvers_.front().solve(ass, lits)) {
+            auto reason = solvers_.front().reason();
+            reasons_.emplace_back(reason.begin(), reason.end());
+            return false;
+        }
+        return true;
+    }
+
+    // distribute the literals to the components
+    for (auto lit : lits) {
+        for (auto it = lit_components_.find(lit), ie = lit_components_.end(); it != ie && it->first == lit; ++it) {
+            auto &comp_lits = lits_[it->second];
+            if (comp_lits.empty()) {
+                touched_.emplace_back(it->second);
+            }
+            comp_lits.emplace_back(lit);
+        }
+    }
+
+    if (touched_.size() > 1 && options_.propagate_threads != 1) {
+        // the components only read the assignment, which does not change
+        // while this thread waits for the workers
+        if (!pool_) {
+            auto threads = options_.propagate_threads > 0 ? options_.propagate_threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+            pool_ = std::make_unique<WorkerPool>(threads - 1);
+        }
+        results_.assign(touched_.size(), 1);
+        pool_->run(touched_.size(), [&](size_t i) {
+            auto comp = touched_[i];
+            results_[i] = solvers_[comp].solve(ass, lits_[comp]) ? 1 : 0;
+        });
+        // conflicts are reported in the order of the components to keep the
+        // clauses independent of the scheduling
+        for (size_t i = 0, e = touched_.size(); i != e; ++i) {
+            auto comp = touched_[i];
+            solved.emplace_back(comp);
+            if (results_[i] == 0) {
+                auto reason = solvers_[comp].reason();
+                reasons_.emplace_back(reason.begin(), reason.end());
+            }
+            lits_[comp].clear();
+        }
+        touched_.clear();
+        return reasons_.empty();
+    }
+
+    for (auto comp : touched_) {
+        auto &comp_lits = lits_[comp];
+        if (reasons_.empty()) {
+            solved.emplace_back(comp);
+            if (!solvers_[comp].solve(ass, comp_lits)) {
+                auto reason = solvers_[comp].reason();
+                reasons_.emplace_back(reason.begin(), reason.end());
+            }
+        }
+        comp_lits.clear();
+    }
+    touched_.clear();
+    return reasons_.empty();
+}
+
+template<typename Factor, typename Value>
+void Components<Factor, Value>::undo() {
+    auto &solved = levels_.back().second;
+    // a component is solved at most once per level
+    std::sort(solved.begin(), solved.end());
+    solved.erase(std::unique(solved.begin(), solved.end()), solved.end());
+    for (auto comp : solved) {
+        solvers_[comp].undo();
+    }
+    levels_.pop_back();
+}
+
+template<typename Factor, typename Value>
+Statistics Components<Factor, Value>::statistics() const {
+    Statistics ret;
+    for (auto const &slv : solvers_) {
+        auto const &stats = slv.statistics();
+        ret.pivots_ += stats.pivots_;
+        ret.fill_in_ += stats.fill_in_;
+        ret.numerator_bits_ = std::max(ret.numerator_bits_, stats.numerator_bits_);
+        ret.denominator_bits_ = std::max(ret.denominator_bits_, stats.denominator_bits_);
+        ret.removed_rows_ += stats.removed_rows_;
+        ret.removed_columns_ += stats.removed_columns_;
+        ret.memory_.add(stats.memory_);
+        ret.memory_peak_.add(stats.memory_peak_);
+        ret.memory_peak_total_ = std::max(ret.memory_peak_total_, stats.memory_peak_total_);
+    }
+    ret.memory_peak_total_ = std::max(ret.memory_peak_total_, memory_peak_total_);
+    return ret;
+}
+
+template<typename Factor, typename Value>
+void Components<Factor, Value>::sample_memory() {
+    size_t total = 0;
+    for (auto &slv : solvers_) {
+        slv.sample_memory();
+        total += slv.statistics().memory_.total();
+    }
+    memory_peak_total_ = std::max(memory_peak_total_, total);
+}
+
+template<typename Factor, typename Value>
+size_t Components<Factor, Value>::warm_start(std::vector<std::string> const &basic) {
+    size_t ret = 0;
+    for (auto &slv : solvers_) {
+        ret += slv.warm_start(basic);
+    }
+    return ret;
+}
+
+template<typename Factor, typename Value>
+Solver<Factor, Value> const &Components<Factor, Value>::single_() const {
+    if (solvers_.size() != 1) {
+        throw std::runtime_error("this operation requires a problem that is not decomposed into components");
+    }
+    return solvers_.front();
+}
+
+template<typename Factor, typename Value>
+void Components<Factor, Value>::save_snapshot(Clingo::PropagateInit &init, Problem const &problem, SnapshotWriter &out) const {
+    single_().save_snapshot(init, problem, out);
+}
+
+template<typename Factor, typename Value>
+bool Components<Factor, Value>::load_snapshot(Clingo::PropagateInit &init, SnapshotReader &in) {
+    solvers_.clear();
+    var_components_.clear();
+    lit_components_.clear();
+    lits_.clear();
+    touched_.clear();
+    levels_.clear();
+    memory_peak_total_ = 0;
+    decompose_ = false;
+    assignment_.clear();
+    solvers_.emplace_back(options_);
+    lits_.emplace_back();
+    return solvers_.back().load_snapshot(init, in);
+}
+
+template<typename Factor, typename Value>
+void Components<Factor, Value>::write_problem(std::ostream &out, bool mps) const {
+    single_().write_problem(out, mps);
+}
+
+template<typename Factor, typename Value>
+void Components<Factor, Value>::write_basis(std::ostream &out) const {
+    single_().write_basis(out);
+}
+
 template<typename Factor, typename Value>
 void Propagator<Factor, Value>::init(Clingo::PropagateInit &init) {
-    slvs_.reserve(init.number_of_threads());
-    for (size_t i = 0, e = init.number_of_threads(); i != e; ++i) {
-        slvs_.emplace_back();
-        if (!slvs_.back().prepare(init, evaluate_theory(init.theory_atoms()))) {
+    ++generation_;
+    // In multi-shot solving, theory atoms of previous steps are usually kept.
+    // They are recognized by the literal of the last atom of the previous
+    // step and skipped.
+    auto theory = init.theory_atoms();
+    size_t offset = 0;
+    if (n_atoms_ > 0 && n_atoms_ <= theory.size() && (*(theory.begin() + static_cast<std::ptrdiff_t>(n_atoms_ - 1))).literal() == last_atom_) {
+        offset = n_atoms_;
+    }
+    auto n_threads = static_cast<size_t>(init.number_of_threads());
+    // snapshots and saved bases only apply to the first step
+    bool first = slvs_.empty();
+    if (!first && slvs_.size() != n_threads) {
+        // the solvers are prepared from scratch if the number of threads changes
+        if (offset != n_atoms_) {
+            throw std::runtime_error("the number of threads cannot change if theory atoms are not kept between steps");
+        }
+        slvs_.clear();
+        aux_.clear();
+        offset = 0;
+        n_rows_ = 0;
+    }
+    else if (!first && loaded_) {
+        // a snapshot does not record the auxiliary variables of conditional
+        // terms, so the solvers are prepared from scratch in later steps
+        if (offset != n_atoms_) {
+            throw std::runtime_error("snapshots cannot be extended if theory atoms are not kept between steps");
+        }
+        slvs_.clear();
+        aux_.clear();
+        offset = 0;
+        n_rows_ = 0;
+    }
+    loaded_ = false;
+    n_atoms_ = theory.size();
+    last_atom_ = n_atoms_ > 0 ? (*(theory.begin() + static_cast<std::ptrdiff_t>(n_atoms_ - 1))).literal() : 0;
+
+    if (first && !options_.load_snapshot.empty()) {
+        n_rows_ = problem_.size();
+        slvs_.reserve(n_threads);
+        MappedFile file{options_.load_snapshot.c_str()};
+        loaded_ = true;
+        for (size_t i = 0; i != n_threads; ++i) {
+            SnapshotReader in{file.data(), file.size()};
+            check_snapshot_(init, in);
+            slvs_.emplace_back(options_);
+            if (!slvs_.back().load_snapshot(init, in)) {
+                return;
+            }
+        }
+        warm_start_();
+        return;
+    }
+
+    auto threads = options_.parse_threads > 0 ? options_.parse_threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+    auto problem = evaluate_theory(theory, threads, offset, aux_);
+    problem.append(problem_, n_rows_);
+    n_rows_ = problem_.size();
+
+    // extend the solvers of the previous step
+    if (!slvs_.empty() && slvs_.front().can_extend(problem)) {
+        for (auto &slv : slvs_) {
+            if (!slv.extend(init, problem)) {
+                return;
+            }
+        }
+        return;
+    }
+
+    // the solvers are prepared from scratch if variables of the difference
+    // logic engine are connected to other rows
+    if (!slvs_.empty()) {
+        slvs_.clear();
+        aux_.clear();
+        problem = evaluate_theory(theory, threads, 0, aux_);
+        problem.append(problem_);
+    }
+
+    auto order = options_.reorder ? problem.bandwidth_order() : std::vector<size_t>{};
+    slvs_.reserve(n_threads);
+    for (size_t i = 0; i != n_threads; ++i) {
+        slvs_.emplace_back(options_);
+        if (!slvs_.back().prepare(init, problem, order)) {
             return;
         }
     }
+
+    if (!first) {
+        return;
+    }
+
+    if (!options_.save_snapshot.empty()) {
+        std::ofstream file{options_.save_snapshot, std::ios::binary};
+        if (!file) {
+            throw std::runtime_error("could not open file: " + options_.save_snapshot);
+        }
+        SnapshotWriter out{file};
+        out.write_u32(std::is_same_v<Value, NumberQ> ? 1 : 0);
+        out.write_u64(theory.size());
+        out.write_u64(problem_.size());
+        slvs_.front().save_snapshot(init, problem, out);
+    }
+
+    warm_start_();
+}
+
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::warm_start_() {
+    if (options_.load_basis.empty()) {
+        return;
+    }
+    std::ifstream file{options_.load_basis};
+    if (!file) {
+        throw std::runtime_error("could not open file: " + options_.load_basis);
+    }
+    auto basic = read_basis(file);
+    for (auto &slv : slvs_) {
+        static_cast<void>(slv.warm_start(basic));
+    }
+}
+
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::check_snapshot_(Clingo::PropagateInit &init, SnapshotReader &in) const {
+    if (in.read_u32() != (std::is_same_v<Value, NumberQ> ? 1 : 0)) {
+        throw std::runtime_error("snapshot has been written with a different value type");
+    }
+    if (in.read_u64() != init.theory_atoms().size() || in.read_u64() != problem_.size()) {
+        throw std::runtime_error("snapshot has been written for a different program");
+    }
 }
 
 template<typename Factor, typename Value>
@@ -681,6 +2224,42 @@ void Propagator<Factor, Value>::register_control(Clingo::Control &ctl) {
     }
 }
 
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::add_problem(Problem const &problem) {
+    problem_.append(problem);
+}
+
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::extend_model(Clingo::Model &model) const {
+    auto thread_id = model.thread_id();
+    if (!options_.show_values || thread_id >= slvs_.size()) {
+        return;
+    }
+    auto const &sigs = options_.show_signatures;
+    std::vector<Clingo::Symbol> symbols;
+    // Note: only the values of selected variables are converted
+    slvs_[thread_id].assignment([&](Clingo::Symbol var, Value const &val) {
+        if (sigs.empty() || std::any_of(sigs.begin(), sigs.end(), [var](auto const &sig) { return var.match(sig.first.c_str(), sig.second); })) {
+            symbols.emplace_back(Clingo::Function("lpx", {var, value_symbol(val)}));
+        }
+    });
+    model.extend(symbols);
+}
+
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::write_problem(std::ostream &out, bool mps) const {
+    if (!slvs_.empty()) {
+        slvs_.front().write_problem(out, mps);
+    }
+}
+
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::write_basis(std::ostream &out, index_t thread_id) const {
+    if (thread_id < slvs_.size()) {
+        slvs_[thread_id].write_basis(out);
+    }
+}
+
 template<typename Factor, typename Value>
 void Propagator<Factor, Value>::on_statistics(Clingo::UserStatistics step, Clingo::UserStatistics accu) {
     auto step_simplex = step.add_subkey("Simplex", Clingo::StatisticsType::Map);
@@ -691,13 +2270,89 @@ void Propagator<Factor, Value>::on_statistics(Clingo::UserStatistics step, Cling
         step_pivots.set_value(slv.statistics().pivots_);
         accu_pivots.set_value(accu_pivots.value() + slv.statistics().pivots_);
     }
+    auto step_fill_in = step_simplex.add_subkey("Fill-In", Clingo::StatisticsType::Value);
+    auto accu_fill_in = accu_simplex.add_subkey("Fill-In", Clingo::StatisticsType::Value);
+    auto step_num_bits = step_simplex.add_subkey("Numerator Bits", Clingo::StatisticsType::Value);
+    auto accu_num_bits = accu_simplex.add_subkey("Numerator Bits", Clingo::StatisticsType::Value);
+    auto step_den_bits = step_simplex.add_subkey("Denominator Bits", Clingo::StatisticsType::Value);
+    auto accu_den_bits = accu_simplex.add_subkey("Denominator Bits", Clingo::StatisticsType::Value);
+    auto step_removed_rows = step_simplex.add_subkey("Removed Rows", Clingo::StatisticsType::Value);
+    auto accu_removed_rows = accu_simplex.add_subkey("Removed Rows", Clingo::StatisticsType::Value);
+    auto step_removed_cols = step_simplex.add_subkey("Removed Columns", Clingo::StatisticsType::Value);
+    auto accu_removed_cols = accu_simplex.add_subkey("Removed Columns", Clingo::StatisticsType::Value);
+    for (auto const &slv : slvs_) {
+        auto const &stats = slv.statistics();
+        step_fill_in.set_value(step_fill_in.value() + stats.fill_in_);
+        accu_fill_in.set_value(accu_fill_in.value() + stats.fill_in_);
+        step_num_bits.set_value(std::max(step_num_bits.value(), static_cast<double>(stats.numerator_bits_)));
+        accu_num_bits.set_value(std::max(accu_num_bits.value(), static_cast<double>(stats.numerator_bits_)));
+        step_den_bits.set_value(std::max(step_den_bits.value(), static_cast<double>(stats.denominator_bits_)));
+        accu_den_bits.set_value(std::max(accu_den_bits.value(), static_cast<double>(stats.denominator_bits_)));
+        step_removed_rows.set_value(step_removed_rows.value() + stats.removed_rows_);
+        accu_removed_rows.set_value(accu_removed_rows.value() + stats.removed_rows_);
+        step_removed_cols.set_value(step_removed_cols.value() + stats.removed_columns_);
+        accu_removed_cols.set_value(accu_removed_cols.value() + stats.removed_columns_);
+    }
+    auto step_memory = step_simplex.add_subkey("Memory", Clingo::StatisticsType::Map);
+    auto accu_memory = accu_simplex.add_subkey("Memory", Clingo::StatisticsType::Map);
+    for (size_t thread_id = 0; thread_id < slvs_.size(); ++thread_id) {
+        auto name = "Thread " + std::to_string(thread_id);
+        // memory is sampled once more because the last periodic sample may
+        // be outdated
+        slvs_[thread_id].sample_memory();
+        auto stats = slvs_[thread_id].statistics();
+        auto step_thread = step_memory.add_subkey(name.c_str(), Clingo::StatisticsType::Map);
+        auto accu_thread = accu_memory.add_subkey(name.c_str(), Clingo::StatisticsType::Map);
+        add_memory_statistics(step_thread, stats.memory_, stats.memory_.total(), false);
+        add_memory_statistics(step_thread.add_subkey("Peak", Clingo::StatisticsType::Map), stats.memory_peak_, stats.memory_peak_total_, true);
+        add_memory_statistics(accu_thread, stats.memory_, stats.memory_.total(), false);
+        add_memory_statistics(accu_thread.add_subkey("Peak", Clingo::StatisticsType::Map), stats.memory_peak_, stats.memory_peak_total_, true);
+    }
+#ifdef CLINGOLPX_PERF
+    auto step_perf = step_simplex.add_subkey("Perf", Clingo::StatisticsType::Map);
+    auto accu_perf = accu_simplex.add_subkey("Perf", Clingo::StatisticsType::Map);
+    for (size_t thread_id = 0; thread_id < slvs_.size(); ++thread_id) {
+        auto name = "Thread " + std::to_string(thread_id);
+        auto step_thread = step_perf.add_subkey(name.c_str(), Clingo::StatisticsType::Map);
+        auto accu_thread = accu_perf.add_subkey(name.c_str(), Clingo::StatisticsType::Map);
+        // the counters of the components are summed up
+        bool first = true;
+        for (auto const &slv : slvs_[thread_id].solvers()) {
+            add_perf_statistics(step_thread, slv.perf(), !first);
+            add_perf_statistics(accu_thread, slv.perf(), true);
+            first = false;
+        }
+    }
+#endif
+}
+
+#ifdef CLINGOLPX_TRACE
+template<typename Factor, typename Value>
+void Propagator<Factor, Value>::write_trace(std::ostream &out) const {
+    trace_begin(out);
+    bool comma = false;
+    // each component gets its own trace thread because components of the
+    // same solver thread might propagate concurrently
+    size_t tid = 0;
+    for (size_t thread_id = 0; thread_id < slvs_.size(); ++thread_id) {
+        auto const &solvers = slvs_[thread_id].solvers();
+        for (size_t component = 0; component < solvers.size(); ++component) {
+            comma = solvers[component].trace().write(out, tid++, thread_id, component, comma) || comma;
+        }
+    }
+    trace_end(out);
 }
+#endif
 
 template<typename Factor, typename Value>
 void Propagator<Factor, Value>::propagate(Clingo::PropagateControl &ctl, Clingo::LiteralSpan changes) {
     auto &slv = slvs_[ctl.thread_id()];
     if (!slv.solve(ctl, changes)) {
-        ctl.add_clause(slv.reason());
+        for (auto const &reason : slv.reasons()) {
+            if (!ctl.add_clause(reason)) {
+                return;
+            }
+        }
     }
 }
 
@@ -708,5 +2363,7 @@ void Propagator<Factor, Value>::undo(Clingo::PropagateControl const &ctl, Clingo
 
 template class Solver<Number, Number>;
 template class Solver<Number, NumberQ>;
+template class Components<Number, Number>;
+template class Components<Number, NumberQ>;
 template class Propagator<Number, Number>;
 template class Propagator<Number, NumberQ>;
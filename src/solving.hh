@@ -1,18 +1,126 @@
 #pragma once
 
+#include <difference.hh>
+#include <parsing.hh>
+#include <perf.hh>
+#include <pool.hh>
 #include <problem.hh>
+#include <snapshot.hh>
+#include <trace.hh>
 #include <util.hh>
 
-#include <queue>
+#include <algorithm>
+#include <memory>
+#include <tuple>
 
 using Value = Number;
 using Factor = Number;
 using CoeffcientQ = NumberQ;
 
+//! Bytes held by the data structures of a solver.
+struct Memory {
+    //! Return the sum of all bytes.
+    [[nodiscard]] size_t total() const;
+    //! Add the values of the given memory.
+    void add(Memory const &mem);
+    //! Set each value to the maximum of itself and the corresponding value of
+    //! the given memory.
+    void update_peak(Memory const &mem);
+
+    size_t tableau{0};
+    size_t original_tableau{0};
+    size_t difference{0};
+    size_t bound_trail{0};
+    size_t assignment_trail{0};
+    size_t bounds{0};
+    size_t variables{0};
+};
+
+//! Options to configure the solver.
+struct Options {
+    //! Write the prepared state to this snapshot file.
+    std::string save_snapshot;
+    //! Load the prepared state from this snapshot file instead of preparing
+    //! the theory atoms.
+    std::string load_snapshot;
+    //! Pivot into the basis read from this MPS basis file after preparation.
+    std::string load_basis;
+    //! Solve independent components of the problem with separate solvers.
+    //!
+    //! The problem is not decomposed if snapshots are saved or a basis is
+    //! loaded because these features require a single tableau.
+    bool decompose{true};
+    //! Handle rows of form `x - y <= k` with a difference logic engine.
+    //!
+    //! Only rows whose variables do not interact with other rows are handled
+    //! this way. The engine is not used if snapshots are saved or a basis is
+    //! loaded because these features require all rows in the tableau.
+    bool difference_logic{true};
+    //! Simplify the tableau whenever bounds are assigned on the top level.
+    //!
+    //! Columns of non-basic variables fixed on the top level and rows of
+    //! slack variables whose literals are false on the top level are removed
+    //! from the tableau.
+    bool simplify{true};
+    //! Order the rows and variables to reduce the bandwidth of the tableau
+    //! before preparing it.
+    //!
+    //! Pivots still follow Bland's rule w.r.t. the new order, which improves
+    //! the locality of the row and column operations on large problems.
+    bool reorder{true};
+    //! Add facts `lpx(var, value)` with the values of variables to models.
+    bool show_values{false};
+    //! Restrict the facts to variables matching these signatures.
+    //!
+    //! The values of all variables are added if the list is empty.
+    std::vector<std::pair<std::string, unsigned>> show_signatures;
+    //! The number of threads used to evaluate theory atoms.
+    //!
+    //! A value of zero uses one thread per hardware thread.
+    size_t parse_threads{1};
+    //! The number of threads used to solve independent components during
+    //! propagation.
+    //!
+    //! Each solver thread of clingo uses its own threads. A value of zero uses
+    //! one thread per hardware thread.
+    size_t propagate_threads{1};
+};
+
+//! Parse the argument of the option to show values.
+//!
+//! The argument is either `all` or a comma-separated list of signatures of
+//! form `name/arity`.
+[[nodiscard]] bool parse_show_values(char const *value, Options &options);
+
 struct Statistics {
     void reset();
 
     size_t pivots_{0};
+    //! The number of non-zero coefficients added to the tableau by pivoting.
+    int64_t fill_in_{0};
+    //! The maximum number of bits of a numerator in a pivot row.
+    size_t numerator_bits_{0};
+    //! The maximum number of bits of a denominator in a pivot row.
+    size_t denominator_bits_{0};
+    //! The number of rows removed by top-level simplification.
+    size_t removed_rows_{0};
+    //! The number of columns removed by top-level simplification.
+    size_t removed_columns_{0};
+    //! The memory of the last sample.
+    Memory memory_;
+    //! The maximum memory over all samples.
+    //!
+    //! The maxima of the individual values are taken independently and might
+    //! stem from different samples.
+    Memory memory_peak_;
+    //! The maximum total memory over all samples.
+    size_t memory_peak_total_{0};
+    //! The number of pivots when memory was sampled last.
+    size_t memory_sampled_{0};
+    //! The capacity of the bound trail when memory was sampled last.
+    size_t memory_sampled_bound_trail_{0};
+    //! The capacity of the assignment trail when memory was sampled last.
+    size_t memory_sampled_assignment_trail_{0};
 };
 
 //! A solver for finding an assignment satisfying a set of inequalities.
@@ -43,7 +151,10 @@ private:
         Clingo::literal_t lit{0};
         BoundRelation rel{BoundRelation::LessEqual};
     };
-    //! Capture the current state of a variable.
+    //! Capture the bounds and position of a variable.
+    //!
+    //! The values of the variables are stored separately in `values_` and
+    //! `levels_` to keep this structure small.
     struct Variable {
         //! Adjusts the lower bound of the variable with the value of the given bound.
         [[nodiscard]] bool update_lower(Solver &s, Clingo::Assignment ass, Bound const &bound);
@@ -51,38 +162,101 @@ private:
         [[nodiscard]] bool update_upper(Solver &s, Clingo::Assignment ass, Bound const &bound);
         //! Adjusts the bounds of the variable w.r.t. to the relation of the bound.
         [[nodiscard]] bool update(Solver &s, Clingo::Assignment ass, Bound const &bound);
-        //! Check if te value of the variable conflicts with the bounds;
-        [[nodiscard]] bool has_conflict() const;
         //! Check if the variable has a lower bound.
         [[nodiscard]] bool has_lower() const { return lower_bound != nullptr; }
         //! Check if the variable has an upper bound.
         [[nodiscard]] bool has_upper() const { return upper_bound != nullptr; }
+        //! Check if the variable is the slack variable of an inequality.
+        [[nodiscard]] bool is_slack() const { return original_row != std::numeric_limits<index_t>::max(); }
+        //! Check if the variable is a slack variable without bounds.
+        //!
+        //! The values of inactive basic variables are not maintained. Their
+        //! rows are still eliminated in `Tableau::pivot` and hence up to date
+        //! once the variables obtain bounds.
+        [[nodiscard]] bool is_inactive() const { return is_slack() && !has_lower() && !has_upper(); }
         //! Return the value of the lower bound.
         [[nodiscard]] Value const &lower() const { return lower_bound->value; }
         //! Return thevalue of the upper bound.
         [[nodiscard]] Value const &upper() const { return upper_bound->value; }
-        //! Set a new value or add to the existing one.
-        void set_value(Solver &s, index_t level, Value const &num, bool add);
 
         //! The lower bound of a variable.
         Bound const *lower_bound{nullptr};
         //! The upper bound of a variable.
         Bound const *upper_bound{nullptr};
-        //! The value of the variable.
-        Value value{0};
-        //! Helper index for pivoting variables.
-        index_t index{0};
         //! Helper index to obtain row/column index of a variable.
         index_t reserve_index{0};
-        //! The level the variable was assigned on.
-        index_t level{0};
-        //! Whether this variales is in the queue of conflicting variables.
-        bool queued{false};
+        //! The row of a slack variable in the original tableau.
+        index_t original_row{std::numeric_limits<index_t>::max()};
+        //! Whether this variable is in the list of non-basic slack variables.
+        bool listed{false};
+        //! Whether the row or column of this variable has been removed from
+        //! the tableau by top-level simplification.
+        bool removed{false};
     };
     struct TrailOffset {
         index_t level;
         index_t bound;
         index_t assignment;
+        index_t edge;
+    };
+    //! Trail of old values of variables (level, variable, Value).
+    //!
+    //! Entries removed from the trail are kept as a pool so that the storage
+    //! of their values is reused by later entries.
+    class AssignmentTrail {
+    public:
+        using Entry = std::tuple<index_t, index_t, Value>;
+        using iterator = typename std::vector<Entry>::iterator;
+
+        //! Add an entry for the given level and variable.
+        //!
+        //! Returns a reference to the value of the entry, which holds an
+        //! arbitrary value that has to be overwritten by the caller.
+        [[nodiscard]] Value &push(index_t level, index_t var) {
+            if (size_ == entries_.size()) {
+                entries_.emplace_back(level, var, Value{});
+            }
+            auto &entry = entries_[size_++];
+            std::get<0>(entry) = level;
+            std::get<1>(entry) = var;
+            return std::get<2>(entry);
+        }
+        //! Remove entries until the trail has the given size.
+        void shrink(size_t size) {
+            assert(size <= size_);
+            size_ = size;
+        }
+        //! Remove all entries.
+        void clear() {
+            size_ = 0;
+        }
+        //! Return the number of entries.
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+        //! Return the number of entries the trail can hold without
+        //! reallocating.
+        [[nodiscard]] size_t capacity() const {
+            return entries_.capacity();
+        }
+        //! Return the bytes held by the trail including pooled entries.
+        [[nodiscard]] size_t bytes() const {
+            auto ret = entries_.capacity() * sizeof(Entry);
+            for (auto const &entry : entries_) {
+                ret += dynamic_bytes(std::get<2>(entry));
+            }
+            return ret;
+        }
+        [[nodiscard]] iterator begin() {
+            return entries_.begin();
+        }
+        [[nodiscard]] iterator end() {
+            return entries_.begin() + static_cast<std::ptrdiff_t>(size_);
+        }
+
+    private:
+        std::vector<Entry> entries_;
+        size_t size_{0};
     };
     //! Captures what is know about of the satisfiability of a problem while
     //! solving.
@@ -93,27 +267,184 @@ private:
     };
 
 public:
-    //! Prepare inequalities for solving.
-    [[nodiscard]] bool prepare(Clingo::PropagateInit &init, std::vector<Inequality> &&inequalities);
+    //! Construct a solver with the given options.
+    explicit Solver(Options const &options = Options{});
+
+    //! Prepare the inequalities of a problem for solving.
+    [[nodiscard]] bool prepare(Clingo::PropagateInit &init, Problem const &problem);
+
+    //! Prepare the inequalities of a problem in the given order of rows.
+    //!
+    //! An empty order keeps the rows in the order of the problem.
+    [[nodiscard]] bool prepare(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order);
+
+    //! Add the inequalities of a problem to an already prepared solver.
+    //!
+    //! The current basis, assignment, and bounds are kept. Variables of the
+    //! problem are identified with existing ones by their symbols. New
+    //! variables are added as non-basic and new inequalities as basic
+    //! variables expressed in terms of the current non-basic variables. This
+    //! function must only be called on the top level.
+    [[nodiscard]] bool extend(Clingo::PropagateInit &init, Problem const &problem);
+
+    //! Check if the inequalities of a problem can be added via `extend`.
+    //!
+    //! This is not possible if variables handled by the difference logic
+    //! engine would have to be moved to the tableau.
+    [[nodiscard]] bool can_extend(Problem const &problem) const;
 
     //! Solve the (previously prepared) problem.
-    [[nodiscard]] bool solve(Clingo::PropagateControl &ctl, Clingo::LiteralSpan lits);
+    [[nodiscard]] bool solve(Clingo::PropagateControl &ctl, Clingo::LiteralSpan lits) {
+        return solve(ctl.assignment(), lits);
+    }
+
+    //! Solve the (previously prepared) problem w.r.t. the given assignment.
+    //!
+    //! This function only reads the assignment and can be called for
+    //! different solvers in parallel.
+    [[nodiscard]] bool solve(Clingo::Assignment ass, Clingo::LiteralSpan lits);
 
     //! Undo assignments on the current level.
     void undo();
 
-    //! Get the current assignment.
-    std::vector<std::pair<Clingo::Symbol, Value>> assignment() const;
+    //! Call `f(var, value)` for each variable in the current assignment.
+    //!
+    //! Variables are traversed in the order of their symbols.
+    template <typename F>
+    void assignment(F &&f) const {
+        for (size_t i = 0, e = assignment_.size(); i != e; ++i) {
+            assignment(i, f);
+        }
+    }
+
+    //! Return the number of variables in the assignment.
+    [[nodiscard]] size_t assignment_size() const { return assignment_.size(); }
+
+    //! Return the symbol of the `i`-th variable in the assignment.
+    [[nodiscard]] Clingo::Symbol assignment_symbol(size_t i) const { return assignment_[i].first; }
+
+    //! Check if the `i`-th variable in the assignment occurs in the tableau
+    //! or the difference logic engine.
+    //!
+    //! Other variables only occur with zero coefficients and have value zero.
+    [[nodiscard]] bool assignment_known(size_t i) const {
+        auto index = assignment_[i].second;
+        return index < variables_.size() || is_node_(index);
+    }
+
+    //! Call `f(var, value)` for the `i`-th variable in the assignment.
+    template <typename F>
+    void assignment(size_t i, F &&f) const {
+        static Value const zero{0};
+        auto const &[var, index] = assignment_[i];
+        if (index < variables_.size()) {
+            f(var, values_[index]);
+        }
+        else if (is_node_(index)) {
+            f(var, difference_.value(index & ~NODE_BIT));
+        }
+        else {
+            f(var, zero);
+        }
+    }
 
     //! Return the solve statistics.
     [[nodiscard]] Statistics const &statistics() const;
 
+    //! Sample the memory held by the solver's data structures.
+    //!
+    //! This function is linear in the size of the tableau and trails.
+    void sample_memory();
+
+    //! Pivot the variables with the given names into the basis.
+    //!
+    //! This function must be called right after preparation. Names are
+    //! matched against the names used when exporting the problem. Names that
+    //! do not occur in the problem and variables that would make the basis
+    //! singular are skipped. The function returns the number of pivots.
+    size_t warm_start(std::vector<std::string> const &basic);
+
+    //! Write the prepared state of the solver to a snapshot.
+    //!
+    //! The snapshot stores program literals, which are obtained from the
+    //! problem the solver has been prepared with.
+    void save_snapshot(Clingo::PropagateInit &init, Problem const &problem, SnapshotWriter &out) const;
+
+    //! Restore the prepared state of the solver from a snapshot instead of
+    //! preparing a problem.
+    [[nodiscard]] bool load_snapshot(Clingo::PropagateInit &init, SnapshotReader &in);
+
+    //! Write the prepared problem in LP or free MPS format.
+    //!
+    //! Each row of the original tableau becomes an equation defining its
+    //! basic variable and each bound becomes a row named after the literal
+    //! guarding it. All variables are free.
+    void write_problem(std::ostream &out, bool mps) const;
+
+    //! Write the current basis of the problem written by `write_problem` in
+    //! MPS basis format.
+    void write_basis(std::ostream &out) const;
+
     //! Return the conflict clause.
     [[nodiscard]] Clingo::LiteralSpan reason() const { return conflict_clause_; }
 
+#ifdef CLINGOLPX_TRACE
+    //! Return the buffer of recorded solver events.
+    [[nodiscard]] TraceBuffer const &trace() const { return trace_; }
+#endif
+#ifdef CLINGOLPX_PERF
+    //! Return the hardware counters collected per solver phase.
+    [[nodiscard]] PerfCounters const &perf() const { return perf_; }
+#endif
+
 private:
-    //! Return the variables occuring in the inequalities.
-    std::vector<Clingo::Symbol> vars_() const;
+    //! Indices of variables handled by the difference logic engine are
+    //! marked with this bit.
+    static constexpr index_t NODE_BIT = index_t{1} << 31U;
+
+    //! Check if the given index refers to a node of the difference logic
+    //! engine.
+    [[nodiscard]] static bool is_node_(index_t index) {
+        return index != std::numeric_limits<index_t>::max() && (index & NODE_BIT) != 0;
+    }
+
+    //! Determine for each variable of the problem whether it is handled by
+    //! the difference logic engine.
+    //!
+    //! These are the variables connected only via rows with two variables
+    //! and coefficients of opposite sign and equal magnitude to each other
+    //! and not to variables in the tableau.
+    [[nodiscard]] std::vector<bool> difference_vars_(Problem const &problem) const;
+
+    //! Add the rows of a problem in the given order.
+    //!
+    //! An empty order keeps the rows in the order of the problem.
+    [[nodiscard]] bool extend_(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order);
+
+    //! Add edges to the difference logic engine for `x - y rel k`.
+    void add_difference_(Clingo::literal_t lit, index_t x, index_t y, Value k, BoundRelation rel);
+
+    //! Return names for all variables that can be used in LP and MPS files.
+    [[nodiscard]] std::vector<std::string> export_names_() const;
+
+    //! Check whether memory should be sampled after pivoting or assigning
+    //! bounds.
+    //!
+    //! This is the case if sufficiently many pivots have been performed or
+    //! a trail has grown beyond its capacity at the last sample.
+    [[nodiscard]] bool should_sample_memory_() const;
+
+    //! Remove fixed non-basic variables and basic slack variables that can
+    //! no longer obtain bounds from the tableau.
+    //!
+    //! This function must only be called on the top level with a satisfying
+    //! assignment. Because all bounds assigned on the top level are
+    //! permanent, the values of fixed variables never change again and their
+    //! contributions to the basic variables are constant.
+    void simplify_(Clingo::Assignment ass);
+
+    //! Clear the rows and columns of removed variables in the tableau.
+    void compact_();
 
     //! Check if the tableau.
     [[nodiscard]] bool check_tableau_();
@@ -124,17 +455,31 @@ private:
     //! Check if the current assignment is a solution.
     [[nodiscard]] bool check_solution_();
 
+    //! Add a variable with value zero and return its index.
+    index_t add_var_();
+
+    //! Set the value of a variable or add to its existing value.
+    //!
+    //! The previous value is recorded on the trail once per level.
+    void set_value_(index_t var, index_t level, Value const &val, bool add);
+
     //! Enqueue basic variable `x_i` if it is conflicting.
     void enqueue_(index_t i);
 
+    //! Compute the value of a slack variable from its row in the original
+    //! tableau.
+    [[nodiscard]] Value slack_value_(Variable const &x) const;
+
     //! Set the value of non-basic `x_j` variable to `v`.
+    //!
+    //! Inactive basic variables are not adjusted.
     void update_(index_t level, index_t j, Value v);
 
     //! Pivots basic variable `x_i` and non-basic variable `x_j`.
     void pivot_(index_t level, index_t i, index_t j, Value const &v);
 
     //! Helper function to select pivot point.
-    [[nodiscard]] bool select_(bool upper, Variable &x);
+    [[nodiscard]] bool select_(bool upper, index_t var);
     //! Select pivot point using Bland's rule.
     State select_(index_t &ret_i, index_t &ret_j, Value const *&ret_v);
 
@@ -143,24 +488,52 @@ private:
     //! Get non-basic variable associated with column `j`.
     Variable &non_basic_(index_t j);
 
-    //! The set of inequalities.
-    std::vector<Inequality> inequalities_;
     //! Mapping from literals to bounds.
     std::unordered_multimap<Clingo::literal_t, Bound> bounds_;
     //! Trail of bound assignments (variable, relation, Value).
     std::vector<std::tuple<index_t, BoundRelation, Bound const *>> bound_trail_;
-    //! Trail for assignments (level, variable, Value).
-    std::vector<std::tuple<index_t, index_t, Value>> assignment_trail_;
+    //! Trail for assignments.
+    AssignmentTrail assignment_trail_;
     //! Trail offsets per level.
     std::vector<TrailOffset> trail_offset_;
-    //! Mapping from symbols to their indices in the assignment.
-    std::unordered_map<Clingo::Symbol, index_t> indices_;
+    //! The sorted variables in the inequalities together with their indices.
+    //!
+    //! Variables that do not occur in the tableau have an invalid index.
+    std::vector<std::pair<Clingo::Symbol, index_t>> assignment_;
+    //! Mapping from the symbols of variables to their indices.
+    std::unordered_map<Clingo::Symbol, index_t> var_ids_;
+    //! The engine handling difference constraints.
+    DifferenceLogic<Value> difference_;
     //! The tableau of coefficients.
     Tableau tableau_;
-    //! The non-basic and basic variables.
+    //! The tableau right after preparation.
+    //!
+    //! The coefficients of each row are integers whose greatest common
+    //! divisor is one.
+    Tableau original_tableau_;
+    //! The basic variables of the rows in the original tableau.
+    std::vector<index_t> original_basic_;
+    //! The non-basic variables of the columns in the original tableau.
+    std::vector<index_t> original_non_basic_;
+    //! The bounds and positions of the variables.
     std::vector<Variable> variables_;
+    //! The values of the variables.
+    std::vector<Value> values_;
+    //! The levels the values of the variables were assigned on.
+    std::vector<index_t> levels_;
+    //! The basic variables associated with the rows of the tableau.
+    std::vector<index_t> row_vars_;
+    //! The non-basic variables associated with the columns of the tableau.
+    std::vector<index_t> col_vars_;
+    //! The slack variables that left the basis.
+    //!
+    //! Their values are recomputed when backtracking because they were not
+    //! maintained while the variables were inactive.
+    std::vector<index_t> slacks_;
     //! The set of conflicting variables.
-    std::priority_queue<index_t, std::vector<index_t>, std::greater<>> conflicts_;
+    //!
+    //! Bland's rule always selects the smallest one.
+    IndexSet conflicts_;
     //! The conflict clause.
     std::vector<Clingo::literal_t> conflict_clause_;
     //! Problem and solving statistics.
@@ -169,26 +542,231 @@ private:
     index_t n_non_basic_{0};
     //! The number of basic variables.
     index_t n_basic_{0};
+    //! The solver options.
+    Options options_;
+    //! Whether difference constraints are handled by the difference logic
+    //! engine.
+    bool use_difference_{false};
+#ifdef CLINGOLPX_TRACE
+    //! The buffer of recorded solver events.
+    TraceBuffer trace_;
+#endif
+#ifdef CLINGOLPX_PERF
+    //! The hardware counters collected per solver phase.
+    PerfCounters perf_;
+#endif
+};
+
+//! Solve the independent components of a problem with separate solvers.
+//!
+//! Components are the connected components of the graph formed by rows and
+//! their variables. Each component has its own tableau, conflict queue, and
+//! trails. Only components with changed bounds are solved during propagation
+//! and undone during backtracking. If multiple propagate threads are
+//! configured, the affected components are solved in parallel.
+template <typename Factor, typename Value>
+class Components {
+public:
+    //! Construct an empty set of components with the given options.
+    explicit Components(Options const &options = Options{});
+
+    //! Prepare the inequalities of a problem for solving.
+    [[nodiscard]] bool prepare(Clingo::PropagateInit &init, Problem const &problem);
+
+    //! Prepare the inequalities of a problem in the given order of rows.
+    //!
+    //! An empty order keeps the rows in the order of the problem.
+    [[nodiscard]] bool prepare(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order);
+
+    //! Add the inequalities of a problem to the already prepared components.
+    //!
+    //! Rows sharing variables with an existing component are added to it and
+    //! the remaining rows form new components.
+    [[nodiscard]] bool extend(Clingo::PropagateInit &init, Problem const &problem);
+
+    //! Check if the inequalities of a problem can be added via `extend`.
+    //!
+    //! This is not possible if rows connect existing components or the
+    //! solver of a component cannot be extended.
+    [[nodiscard]] bool can_extend(Problem const &problem) const;
+
+    //! Solve the components affected by the given literals.
+    //!
+    //! Returns false if at least one component is conflicting. The conflict
+    //! clauses of all conflicting components can then be obtained via
+    //! `reasons`.
+    [[nodiscard]] bool solve(Clingo::PropagateControl &ctl, Clingo::LiteralSpan lits);
+
+    //! Undo the components solved on the current level.
+    void undo();
+
+    //! Call `f(var, value)` for each variable in the current assignment.
+    //!
+    //! Variables are traversed in the order of their symbols.
+    template <typename F>
+    void assignment(F &&f) const {
+        if (solvers_.size() == 1) {
+            solvers_.front().assignment(std::forward<F>(f));
+            return;
+        }
+        for (auto const &[comp, i] : assignment_) {
+            solvers_[comp].assignment(i, f);
+        }
+    }
+
+    //! Return the solve statistics accumulated over all components.
+    //!
+    //! The peak of the total memory is the maximum of the peaks of the
+    //! individual components and the totals summed up by `sample_memory`.
+    [[nodiscard]] Statistics statistics() const;
+
+    //! Sample the memory of all components.
+    void sample_memory();
+
+    //! Pivot the variables with the given names into the basis.
+    size_t warm_start(std::vector<std::string> const &basic);
+
+    //! Write the prepared state of the solver to a snapshot.
+    //!
+    //! This requires a single component.
+    void save_snapshot(Clingo::PropagateInit &init, Problem const &problem, SnapshotWriter &out) const;
+
+    //! Restore the prepared state of the solver from a snapshot.
+    [[nodiscard]] bool load_snapshot(Clingo::PropagateInit &init, SnapshotReader &in);
+
+    //! Write the prepared problem in LP or free MPS format.
+    //!
+    //! This requires a single component.
+    void write_problem(std::ostream &out, bool mps) const;
+
+    //! Write the current basis in MPS basis format.
+    //!
+    //! This requires a single component.
+    void write_basis(std::ostream &out) const;
+
+    //! Return the conflict clauses of the conflicting components.
+    [[nodiscard]] std::vector<std::vector<Clingo::literal_t>> const &reasons() const { return reasons_; }
+
+    //! Return the solvers of the components.
+    [[nodiscard]] std::vector<Solver<Factor, Value>> const &solvers() const { return solvers_; }
+
+private:
+    //! Assign the rows of a problem to components.
+    //!
+    //! Rows sharing variables with an existing component are assigned to it
+    //! and all other rows to new components. Rows without variables are
+    //! assigned to the first component. Returns false if a row connects
+    //! existing components.
+    [[nodiscard]] bool partition_(Problem const &problem, std::vector<index_t> &rows, index_t &n) const;
+
+    //! Add the rows of a problem in the given order.
+    [[nodiscard]] bool extend_(Clingo::PropagateInit &init, Problem const &problem, std::vector<size_t> const &order);
+
+    //! Split a problem into one problem per component.
+    //!
+    //! The rows of the component problems follow the given order.
+    [[nodiscard]] static std::vector<Problem> split_(Problem const &problem, std::vector<index_t> const &rows, index_t n, std::vector<size_t> const &order);
+
+    //! Return the solver of the single component.
+    [[nodiscard]] Solver<Factor, Value> const &single_() const;
+
+    //! Merge the variables of the components in the order of their symbols.
+    void merge_assignment_();
+
+    //! The solvers of the components.
+    std::vector<Solver<Factor, Value>> solvers_;
+    //! The variables of all components as pairs of components and positions
+    //! in their assignments sorted by symbols.
+    //!
+    //! This is only used if there is more than one component.
+    std::vector<std::pair<index_t, index_t>> assignment_;
+    //! Mapping from the symbols of variables to their components.
+    std::unordered_map<Clingo::Symbol, index_t> var_components_;
+    //! Mapping from literals to the components with rows guarded by them.
+    std::unordered_multimap<Clingo::literal_t, index_t> lit_components_;
+    //! The literals passed to each component during propagation.
+    std::vector<std::vector<Clingo::literal_t>> lits_;
+    //! The components solved during the current propagation.
+    std::vector<index_t> touched_;
+    //! The components solved on each level.
+    std::vector<std::pair<uint32_t, std::vector<index_t>>> levels_;
+    //! The results of the components solved in parallel.
+    std::vector<char> results_;
+    //! The conflict clauses.
+    std::vector<std::vector<Clingo::literal_t>> reasons_;
+    //! The workers solving components in parallel.
+    std::unique_ptr<WorkerPool> pool_;
+    //! The solver options.
+    Options options_;
+    //! The maximum total memory of all components over the calls to
+    //! `sample_memory`.
+    size_t memory_peak_total_{0};
+    //! Whether the problem is decomposed into components.
+    bool decompose_{false};
 };
 
 template <typename Factor, typename Value>
 class Propagator : private Clingo::Propagator {
 public:
-    Propagator() = default;
+    explicit Propagator(Options const &options = Options{})
+    : options_{options} { }
     Propagator(Propagator const &) = default;
     Propagator(Propagator &&) noexcept = default;
     Propagator &operator=(Propagator const &) = default;
     Propagator &operator=(Propagator &&) noexcept = default;
     ~Propagator() override = default;
     void register_control(Clingo::Control &ctl);
+    //! Add rows in addition to the ones obtained from the theory atoms.
+    //!
+    //! The literals of the rows must be program literals.
+    void add_problem(Problem const &problem);
+    //! Add the values of the variables selected via the options as facts
+    //! `lpx(var, value)` to the given model.
+    //!
+    //! Integral values are added as numbers and all other values as strings.
+    void extend_model(Clingo::Model &model) const;
+    //! Write the prepared problem in LP or free MPS format.
+    void write_problem(std::ostream &out, bool mps) const;
+    //! Write the current basis of the solver of the given thread.
+    void write_basis(std::ostream &out, index_t thread_id = 0) const;
     void on_statistics(Clingo::UserStatistics step, Clingo::UserStatistics accu);
-    [[nodiscard]] std::vector<std::pair<Clingo::Symbol, Value>> assignment(index_t thread_id) const {
-        return slvs_[thread_id].assignment();
+    //! Call `f(var, value)` for each variable in the current assignment of
+    //! the given thread.
+    template <typename F>
+    void assignment(index_t thread_id, F &&f) const {
+        slvs_[thread_id].assignment(std::forward<F>(f));
     }
+    //! Return the number of times the propagator has been initialized.
+    //!
+    //! The variables in the assignment can only change when this number
+    //! changes.
+    [[nodiscard]] size_t generation() const { return generation_; }
+#ifdef CLINGOLPX_TRACE
+    //! Write the events recorded by all solvers as a Chrome trace.
+    void write_trace(std::ostream &out) const;
+#endif
 private:
+    //! Pivot the solvers into the basis given by option `load_basis`.
+    void warm_start_();
+    //! Check if the header of a snapshot matches the current program.
+    void check_snapshot_(Clingo::PropagateInit &init, SnapshotReader &in) const;
     void init(Clingo::PropagateInit &init) override;
     void propagate(Clingo::PropagateControl &ctl, Clingo::LiteralSpan changes) override;
     void undo(Clingo::PropagateControl const &ctl, Clingo::LiteralSpan changes) noexcept override;
 
-    std::vector<Solver<Factor, Value>> slvs_;
+    std::vector<Components<Factor, Value>> slvs_;
+    Problem problem_;
+    Options options_;
+    //! The auxiliary variables introduced in previous steps.
+    AuxMap aux_;
+    //! The number of theory atoms in the previous step.
+    size_t n_atoms_{0};
+    //! The literal of the last theory atom in the previous step.
+    Clingo::literal_t last_atom_{0};
+    //! The number of rows in `problem_` added to the solvers.
+    size_t n_rows_{0};
+    //! Whether the solvers have been loaded from a snapshot.
+    bool loaded_{false};
+    //! The number of times the propagator has been initialized.
+    size_t generation_{0};
 };
@@ -0,0 +1,122 @@
+#include <trace.hh>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+[[nodiscard]] size_t round_capacity(size_t capacity) {
+    size_t ret = 1;
+    while (ret < capacity) {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+void write_time(std::ostream &out, int64_t time) {
+    // Chrome traces use microseconds
+    auto fill = out.fill('0');
+    out << time / 1000 << "." << std::setw(3) << time % 1000;
+    out.fill(fill);
+}
+
+} // namespace
+
+TraceBuffer::TraceBuffer(size_t capacity)
+: records_{std::make_unique<Record[]>(round_capacity(capacity))}
+, mask_{round_capacity(capacity) - 1} { }
+
+TraceBuffer::TraceBuffer(TraceBuffer const &x)
+: TraceBuffer(x.mask_ + 1) {
+    *this = x;
+}
+
+TraceBuffer::TraceBuffer(TraceBuffer &&x) noexcept
+: records_{std::move(x.records_)}
+, mask_{x.mask_}
+, head_{x.head_.load()} {
+    x.head_ = 0;
+}
+
+TraceBuffer &TraceBuffer::operator=(TraceBuffer const &x) {
+    if (this != &x) {
+        records_ = std::make_unique<Record[]>(x.mask_ + 1);
+        mask_ = x.mask_;
+        std::copy(x.records_.get(), x.records_.get() + x.mask_ + 1, records_.get());
+        head_ = x.head_.load();
+    }
+    return *this;
+}
+
+TraceBuffer &TraceBuffer::operator=(TraceBuffer &&x) noexcept {
+    records_ = std::move(x.records_);
+    mask_ = x.mask_;
+    head_ = x.head_.load();
+    x.head_ = 0;
+    return *this;
+}
+
+bool TraceBuffer::write(std::ostream &out, size_t tid, size_t thread_id, size_t component, bool comma) const {
+    auto head = head_.load(std::memory_order_acquire);
+    auto tail = head > mask_ ? head - mask_ - 1 : 0;
+    // end events whose begin event has been overwritten are dropped
+    size_t depth = 0;
+    bool written = false;
+    for (auto it = tail; it != head; ++it) {
+        auto const &rec = records_[it & mask_];
+        if (rec.event == TraceEvent::PropagateEnd) {
+            if (depth == 0) {
+                continue;
+            }
+            --depth;
+        }
+        if (comma || written) {
+            out << ",\n";
+        }
+        if (!written) {
+            out << R"({"pid":0,"tid":)" << tid
+                << R"(,"ph":"M","name":"thread_name","args":{"name":"thread )" << thread_id
+                << " component " << component << "\"}},\n";
+        }
+        written = true;
+        out << R"({"pid":0,"tid":)" << tid << R"(,"ts":)";
+        write_time(out, rec.time);
+        switch (rec.event) {
+            case TraceEvent::PropagateBegin: {
+                ++depth;
+                out << R"(,"ph":"B","name":"propagate"})";
+                break;
+            }
+            case TraceEvent::PropagateEnd: {
+                out << R"(,"ph":"E","name":"propagate"})";
+                break;
+            }
+            case TraceEvent::Pivot: {
+                out << R"(,"ph":"i","s":"t","name":"pivot","args":{"row":)" << rec.args[0]
+                    << R"(,"column":)" << rec.args[1]
+                    << R"(,"fill_in":)" << rec.args[2] << "}}";
+                break;
+            }
+            case TraceEvent::Conflict: {
+                out << R"(,"ph":"i","s":"t","name":"conflict","args":{"size":)" << rec.args[0] << "}}";
+                break;
+            }
+            case TraceEvent::Undo: {
+                out << R"(,"ph":"i","s":"t","name":"undo","args":{"bounds":)" << rec.args[0]
+                    << R"(,"values":)" << rec.args[1]
+                    << R"(,"bound_trail":)" << rec.args[2]
+                    << R"(,"assignment_trail":)" << rec.args[3] << "}}";
+                break;
+            }
+        }
+    }
+    return written;
+}
+
+void trace_begin(std::ostream &out) {
+    out << R"({"displayTimeUnit":"ns","traceEvents":[)" << "\n";
+}
+
+void trace_end(std::ostream &out) {
+    out << "\n]}\n";
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <util.hh>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#ifdef CLINGOLPX_TRACE
+#   define trace_event(B, ...) (B).push(__VA_ARGS__)
+#else
+#   define trace_event(B, ...)
+#endif
+
+//! The kinds of solver events that can be recorded.
+enum class TraceEvent : uint32_t {
+    //! Begin of a propagate call.
+    PropagateBegin = 0,
+    //! End of a propagate call.
+    PropagateEnd = 1,
+    //! A pivot with arguments row, column, and fill-in.
+    Pivot = 2,
+    //! A conflict with the size of the conflict clause as argument.
+    Conflict = 3,
+    //! An undo with the number of restored bounds and values as well as the
+    //! remaining sizes of the bound and assignment trail as arguments.
+    Undo = 4,
+};
+
+//! A ring buffer of timestamped solver events.
+//!
+//! A buffer is written by exactly one solver thread. Once the buffer is full,
+//! the oldest events are overwritten. Writing does not need any locks; the
+//! buffer should only be flushed after solving finished.
+class TraceBuffer {
+public:
+    //! A single timestamped event.
+    struct Record {
+        int64_t time{0};
+        int64_t args[4]{0, 0, 0, 0};
+        TraceEvent event{TraceEvent::PropagateBegin};
+    };
+
+    explicit TraceBuffer(size_t capacity = size_t{1} << 16);
+    TraceBuffer(TraceBuffer const &x);
+    TraceBuffer(TraceBuffer &&x) noexcept;
+    TraceBuffer &operator=(TraceBuffer const &x);
+    TraceBuffer &operator=(TraceBuffer &&x) noexcept;
+    ~TraceBuffer() = default;
+
+    //! Record an event with the given arguments.
+    void push(TraceEvent event, int64_t a = 0, int64_t b = 0, int64_t c = 0, int64_t d = 0) {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto &rec = records_[head & mask_];
+        rec.time = now_();
+        rec.event = event;
+        rec.args[0] = a;
+        rec.args[1] = b;
+        rec.args[2] = c;
+        rec.args[3] = d;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    //! Write the recorded events as Chrome trace events with the given trace
+    //! thread id.
+    //!
+    //! Each buffer must be written with its own trace thread id because the
+    //! begin and end events of buffers written concurrently would otherwise
+    //! interleave. The trace thread is named after the solver thread and the
+    //! component. Events are separated by commas and the first event is
+    //! prefixed with a comma iff `comma` is true. Returns true if an event has
+    //! been written.
+    bool write(std::ostream &out, size_t tid, size_t thread_id, size_t component, bool comma) const;
+
+private:
+    //! Return the number of nanoseconds since the start of tracing.
+    static int64_t now_() {
+        static auto const epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    std::unique_ptr<Record[]> records_;
+    size_t mask_;
+    std::atomic<size_t> head_{0};
+};
+
+//! Begin a Chrome trace file.
+void trace_begin(std::ostream &out);
+
+//! End a Chrome trace file.
+void trace_end(std::ostream &out);
@@ -2,9 +2,11 @@
 
 #include <unordered_map>
 #include <vector>
+#include <algorithm>
 #include <cstdint>
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <gmpxx.h>
 
 #define CLINGOLP_EXTRA_DEBUG
@@ -17,6 +19,12 @@
 using Number = mpq_class;
 using index_t = uint32_t;
 
+//! Return the number of bytes allocated on the heap for the limbs of a number.
+[[nodiscard]] inline size_t dynamic_bytes(Number const &x) {
+    return (static_cast<size_t>(mpq_numref(x.get_mpq_t())->_mp_alloc) +
+            static_cast<size_t>(mpq_denref(x.get_mpq_t())->_mp_alloc)) * sizeof(mp_limb_t);
+}
+
 //! A sparse matrix with efficient access to both rows and columns.
 //!
 //! Insertion into the matrix is linear in the number of rows/columns and
@@ -128,6 +136,16 @@ public:
         }
     }
 
+    //! Traverse non-zero elements in a row without modifying them.
+    template <typename F>
+    void for_row(index_t i, F &&f) const {
+        if (i < rows_.size()) {
+            for (auto const &[col, val] : rows_[i]) {
+                f(col, val);
+            }
+        }
+    }
+
     //! Traverse non-zero elements in a column.
     //!
     //! The given function must not set the value to zero.
@@ -158,10 +176,13 @@ public:
     //! This is the only function specific to the simplex algorithm. It is
     //! implemented like this to offer better performance and makes a lot of
     //! assumptions.
-    void eliminate(index_t i, index_t j) {
+    //!
+    //! Returns the number of non-zero values added to the tableau.
+    int64_t eliminate(index_t i, index_t j) {
         auto ib = rows_[i].begin();
         auto ie = rows_[i].end();
         std::vector<Cell> row;
+        int64_t fill_in{0};
         update_col(j, [&](index_t k, Number const &a_kj) {
             if (k != i) {
                 // Note that this call does not invalidate active iterators:
@@ -196,10 +217,77 @@ public:
                         ++jt;
                     }
                 }
+                fill_in += static_cast<int64_t>(row.size()) - static_cast<int64_t>(rows_[k].size());
                 std::swap(rows_[k], row);
                 row.clear();
             }
         });
+        return fill_in;
+    }
+
+    //! Pivot row `i` and column `j`.
+    //!
+    //! Solves row `i` for the variable associated with column `j` and
+    //! eliminates it from all other rows. Afterward, row `i` and column `j`
+    //! are associated with the variables swapped by the pivot operation.
+    //!
+    //! Returns the number of non-zero values added to the tableau.
+    int64_t pivot(index_t i, index_t j) {
+        auto &a_ij = unsafe_get(i, j);
+        assert(a_ij != 0);
+
+        // invert row i
+        update_row(i, [&](index_t k, Number &a_ik) {
+            if (k != j) {
+                a_ik /= -a_ij;
+            }
+        });
+        a_ij = 1 / a_ij;
+
+        // eliminate x_j from rows k != i
+        return eliminate(i, j);
+    }
+
+    //! Remove all values in row `i` and release its storage.
+    void clear_row(index_t i) {
+        if (i < rows_.size()) {
+            for (auto const &cell : rows_[i]) {
+                auto &col = cols_[cell.col];
+                auto it = std::lower_bound(col.begin(), col.end(), i);
+                if (it != col.end() && *it == i) {
+                    col.erase(it);
+                }
+            }
+            std::vector<Cell>{}.swap(rows_[i]);
+        }
+    }
+
+    //! Remove all values in column `j` and release its storage.
+    //!
+    //! The storage released in the rows can be reclaimed via `shrink`.
+    void clear_col(index_t j) {
+        if (j < cols_.size()) {
+            for (auto i : cols_[j]) {
+                auto &row = rows_[i];
+                auto it = std::lower_bound(row.begin(), row.end(), j);
+                if (it != row.end() && it->col == j) {
+                    row.erase(it);
+                }
+            }
+            std::vector<index_t>{}.swap(cols_[j]);
+        }
+    }
+
+    //! Release unused capacity of rows and columns.
+    //!
+    //! The runtime of this function is linear in the size of the matrix.
+    void shrink() {
+        for (auto &row : rows_) {
+            row.shrink_to_fit();
+        }
+        for (auto &col : cols_) {
+            col.shrink_to_fit();
+        }
     }
 
     //! Get the number of values in the matrix.
@@ -213,6 +301,24 @@ public:
         return ret;
     }
 
+    //! Get the number of bytes allocated by the tableau including the limbs of
+    //! its values.
+    //!
+    //! The runtime of this function is linear in the size of the matrix.
+    [[nodiscard]] size_t bytes() const {
+        size_t ret = rows_.capacity() * sizeof(std::vector<Cell>) + cols_.capacity() * sizeof(std::vector<index_t>);
+        for (auto const &row : rows_) {
+            ret += row.capacity() * sizeof(Cell);
+            for (auto const &cell : row) {
+                ret += dynamic_bytes(cell.val);
+            }
+        }
+        for (auto const &col : cols_) {
+            ret += col.capacity() * sizeof(index_t);
+        }
+        return ret;
+    }
+
     //! Equivalent to `size() == 0`.
     [[nodiscard]] bool empty() const {
         for (auto const &row : rows_) {
@@ -234,6 +340,133 @@ private:
     std::vector<std::vector<index_t>> cols_;
 };
 
+//! Return the index of the least significant set bit of a non-zero word.
+[[nodiscard]] inline unsigned lowest_bit(uint64_t word) {
+    assert(word != 0);
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+    unsigned ret = 0;
+    for (; (word & 1U) == 0; word >>= 1U) {
+        ++ret;
+    }
+    return ret;
+#endif
+}
+
+//! A set of indices with efficient access to its smallest element.
+//!
+//! The elements are stored in a bitset whose non-empty words are marked in
+//! a second bitset. Clearing the set only resets the words modified since
+//! the last clear and thus takes time linear in the number of insertions.
+class IndexSet {
+public:
+    //! Make room for indices smaller than `n`.
+    void resize(size_t n) {
+        auto n_words = (n + 63) / 64;
+        if (bits_.size() < n_words) {
+            bits_.resize(n_words, 0);
+            words_.resize((n_words + 63) / 64, 0);
+        }
+    }
+
+    //! Check if the set is empty.
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+    //! Check if the set contains index `i`.
+    [[nodiscard]] bool contains(index_t i) const {
+        return (bits_[i / 64] & mask_(i)) != 0;
+    }
+
+    //! Add index `i` to the set.
+    void insert(index_t i) {
+        auto &word = bits_[i / 64];
+        if ((word & mask_(i)) != 0) {
+            return;
+        }
+        if (word == 0) {
+            auto w = i / 64;
+            words_[w / 64] |= mask_(w);
+            if (touched_.size() == bits_.size()) {
+                compact_();
+            }
+            touched_.emplace_back(w);
+            first_ = std::min<size_t>(first_, w / 64);
+        }
+        word |= mask_(i);
+        ++size_;
+    }
+
+    //! Remove index `i` from the set.
+    void erase(index_t i) {
+        auto &word = bits_[i / 64];
+        if ((word & mask_(i)) == 0) {
+            return;
+        }
+        word &= ~mask_(i);
+        if (word == 0) {
+            auto w = i / 64;
+            words_[w / 64] &= ~mask_(w);
+        }
+        if (--size_ == 0) {
+            // all words are zero again
+            touched_.clear();
+            first_ = std::numeric_limits<size_t>::max();
+        }
+    }
+
+    //! Return the smallest index in the non-empty set.
+    [[nodiscard]] index_t min() {
+        assert(!empty());
+        while (words_[first_] == 0) {
+            ++first_;
+        }
+        auto w = first_ * 64 + lowest_bit(words_[first_]);
+        return static_cast<index_t>(w * 64 + lowest_bit(bits_[w]));
+    }
+
+    //! Remove all indices from the set.
+    void clear() {
+        for (auto w : touched_) {
+            bits_[w] = 0;
+            words_[w / 64] = 0;
+        }
+        touched_.clear();
+        size_ = 0;
+        first_ = std::numeric_limits<size_t>::max();
+    }
+
+private:
+    [[nodiscard]] static uint64_t mask_(size_t i) {
+        return uint64_t{1} << (i % 64);
+    }
+
+    //! Keep only the currently non-empty words in `touched_`.
+    //!
+    //! Words become non-empty repeatedly if indices are inserted and erased
+    //! again, which would otherwise let `touched_` grow without bound.
+    void compact_() {
+        touched_.erase(std::remove_if(touched_.begin(), touched_.end(), [this](size_t w) {
+            return bits_[w] == 0;
+        }), touched_.end());
+        std::sort(touched_.begin(), touched_.end());
+        touched_.erase(std::unique(touched_.begin(), touched_.end()), touched_.end());
+    }
+
+    //! The bits of the indices.
+    std::vector<uint64_t> bits_;
+    //! The bits marking non-empty words in `bits_`.
+    std::vector<uint64_t> words_;
+    //! The words that became non-empty since the last clear.
+    std::vector<size_t> touched_;
+    //! The number of indices in the set.
+    size_t size_{0};
+    //! A lower bound on the first non-empty word in `words_`.
+    size_t first_{std::numeric_limits<size_t>::max()};
+};
+
 class NumberQ {
 private:
     friend NumberQ operator+(NumberQ const &q, Number const &c);
@@ -246,6 +479,7 @@ private:
     friend NumberQ operator*(Number  const &c, NumberQ const &q);
     friend NumberQ operator/(NumberQ const &q, Number const &c);
     friend std::ostream &operator<<(std::ostream &out, NumberQ const &q);
+    friend size_t dynamic_bytes(NumberQ const &q);
 
 public:
     explicit NumberQ(Number c = Number{}, Number k = Number{})
@@ -257,6 +491,16 @@ public:
     NumberQ &operator=(NumberQ &&) = default;
     ~NumberQ() = default;
 
+    //! Return the rational component.
+    [[nodiscard]] Number const &c() const {
+        return c_;
+    }
+
+    //! Return the coefficient of the infinitesimal component.
+    [[nodiscard]] Number const &k() const {
+        return k_;
+    }
+
     void swap(NumberQ &q) {
         c_.swap(q.c_);
         k_.swap(q.k_);
@@ -354,7 +598,7 @@ private:
         return mpq_cmp(k_.get_mpq_t(), q.k_.get_mpq_t());
     }
     [[nodiscard]] int cmp_(Number const &c) const {
-        auto ret = mpq_cmp(c_.get_mpq_t(), c_.get_mpq_t());
+        auto ret = mpq_cmp(c_.get_mpq_t(), c.get_mpq_t());
         if (ret != 0) {
             return ret;
         }
@@ -415,6 +659,12 @@ private:
     return NumberQ{q.c_ / c, q.k_ / c};
 }
 
+// memory
+
+[[nodiscard]] inline size_t dynamic_bytes(NumberQ const &q) {
+    return dynamic_bytes(q.c_) + dynamic_bytes(q.k_);
+}
+
 inline std::ostream &operator<<(std::ostream &out, NumberQ const &q) {
     if (q.c_ != 0 || q.k_ == 0) {
         out << q.c_;
@@ -0,0 +1,93 @@
+#include <difference.hh>
+
+#include <catch.hpp>
+#include <algorithm>
+
+TEST_CASE("difference") {
+    SECTION("consistent") {
+        DifferenceLogic<Number> dl;
+        auto x = dl.add_node();
+        auto y = dl.add_node();
+        // x - y <= -2, y <= 3, x >= -1
+        dl.add_edge(1, y, x, Number{-2});
+        dl.add_edge(2, 0, y, Number{3});
+        dl.add_edge(3, x, 0, Number{1});
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.activate(2));
+        REQUIRE(dl.activate(3));
+        REQUIRE(dl.trail_size() == 3);
+        auto vx = dl.value(x);
+        auto vy = dl.value(y);
+        REQUIRE(vx - vy <= -2);
+        REQUIRE(vy <= 3);
+        REQUIRE(vx >= -1);
+    }
+
+    SECTION("negative cycle") {
+        DifferenceLogic<Number> dl;
+        auto x = dl.add_node();
+        auto y = dl.add_node();
+        auto z = dl.add_node();
+        // x - y <= 1, y - z <= 1, z - x <= -3
+        dl.add_edge(1, y, x, Number{1});
+        dl.add_edge(2, z, y, Number{1});
+        dl.add_edge(3, x, z, Number{-3});
+        dl.add_edge(4, x, z, Number{-2});
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.activate(2));
+        auto size = dl.trail_size();
+        REQUIRE(!dl.activate(3));
+        auto reason = dl.reason();
+        std::sort(reason.begin(), reason.end());
+        REQUIRE(reason == std::vector<Clingo::literal_t>{1, 2, 3});
+        REQUIRE(dl.trail_size() == size);
+        // the zero-weight cycle is consistent
+        REQUIRE(dl.activate(4));
+        REQUIRE(dl.value(x) - dl.value(z) == 2);
+        // after removing an edge of the cycle the conflicting edge can be added
+        dl.backtrack(0);
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.activate(3));
+        REQUIRE(dl.value(z) - dl.value(x) <= -3);
+    }
+
+    SECTION("strict") {
+        DifferenceLogic<NumberQ> dl;
+        auto x = dl.add_node();
+        auto y = dl.add_node();
+        // x - y < 0 and y - x < 0
+        dl.add_edge(1, y, x, NumberQ{0, -1});
+        dl.add_edge(2, x, y, NumberQ{0, -1});
+        dl.add_edge(3, x, y, NumberQ{1, -1});
+        REQUIRE(dl.activate(1));
+        REQUIRE(!dl.activate(2));
+        REQUIRE(dl.activate(3));
+        REQUIRE(dl.value(x) < dl.value(y) + NumberQ{1});
+        REQUIRE(dl.value(x) > dl.value(y) - NumberQ{1});
+    }
+
+    SECTION("repeated activation") {
+        DifferenceLogic<Number> dl;
+        auto x = dl.add_node();
+        // x <= 2
+        dl.add_edge(1, 0, x, Number{2});
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.trail_size() == 1);
+        dl.backtrack(0);
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.trail_size() == 1);
+    }
+
+    SECTION("memory") {
+        DifferenceLogic<Number> dl;
+        auto empty = dl.bytes();
+        auto x = dl.add_node();
+        // the weight needs limbs on the heap
+        dl.add_edge(1, 0, x, Number{"123456789012345678901234567890"});
+        auto added = dl.bytes();
+        REQUIRE(added > empty);
+        REQUIRE(dl.activate(1));
+        REQUIRE(dl.bytes() > added);
+    }
+}
@@ -0,0 +1,58 @@
+#include <clingo-lpx.h>
+
+#include <catch.hpp>
+#include <clingo.hh>
+
+TEST_CASE("library") {
+    clingolpx_theory_t *theory = nullptr;
+    REQUIRE(clingolpx_create(&theory));
+    REQUIRE(clingolpx_configure(theory, "strict", "true"));
+    REQUIRE(!clingolpx_configure(theory, "unknown", "1"));
+    {
+        Clingo::Control ctl;
+        REQUIRE(clingolpx_register(theory, ctl.to_c()));
+        REQUIRE(!clingolpx_configure(theory, "strict", "false"));
+        ctl.add("base", {}, "&sum { x } > 1. &sum { x } <= 2. &sum { y } = 3.\n");
+        ctl.ground({{"base", {}}});
+        size_t models = 0;
+        for (auto const &model : ctl.solve()) {
+            REQUIRE(clingolpx_on_model(theory, model.to_c()));
+            ++models;
+        }
+        REQUIRE(models == 1);
+
+        size_t index = 0;
+        clingolpx_value_t value;
+        REQUIRE(clingolpx_lookup_symbol(theory, Clingo::Function("y", {}).to_c(), &index));
+        REQUIRE(clingolpx_assignment_has_value(theory, 0, index));
+        clingolpx_assignment_get_value(theory, 0, index, &value);
+        REQUIRE(value.type == clingolpx_value_type_int);
+        REQUIRE(value.int_number == 3);
+        REQUIRE(!clingolpx_lookup_symbol(theory, Clingo::Function("z", {}).to_c(), &index));
+
+        std::vector<std::string> symbols;
+        clingolpx_assignment_begin(theory, 0, &index);
+        while (clingolpx_assignment_next(theory, 0, &index)) {
+            symbols.emplace_back(Clingo::Symbol{clingolpx_get_symbol(theory, index)}.to_string());
+        }
+        REQUIRE(symbols == std::vector<std::string>{"x", "y"});
+
+        // the symbols are updated in the next step
+        ctl.add("step", {}, "&sum { a } = 5.\n");
+        ctl.ground({{"step", {}}});
+        models = 0;
+        for (auto const &model : ctl.solve()) {
+            REQUIRE(clingolpx_on_model(theory, model.to_c()));
+            ++models;
+        }
+        REQUIRE(models == 1);
+        REQUIRE(clingolpx_lookup_symbol(theory, Clingo::Function("a", {}).to_c(), &index));
+        clingolpx_assignment_get_value(theory, 0, index, &value);
+        REQUIRE(value.type == clingolpx_value_type_int);
+        REQUIRE(value.int_number == 5);
+        REQUIRE(clingolpx_lookup_symbol(theory, Clingo::Function("y", {}).to_c(), &index));
+        clingolpx_assignment_get_value(theory, 0, index, &value);
+        REQUIRE(value.int_number == 3);
+    }
+    REQUIRE(clingolpx_destroy(theory));
+}
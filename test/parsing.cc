@@ -20,7 +20,7 @@ TEST_CASE("parsing") {
 
         auto eqs = evaluate_theory(ctl.theory_atoms());
         REQUIRE(eqs.size() == 1);
-        REQUIRE(str(eqs.front()) == "x2 + x3 >= 10");
+        REQUIRE(str(eqs.inequality(0)) == "x2 + x3 >= 10");
     }
 
     SECTION("example 2") {
@@ -29,7 +29,7 @@ TEST_CASE("parsing") {
 
         auto eqs = evaluate_theory(ctl.theory_atoms());
         REQUIRE(eqs.size() == 1);
-        REQUIRE(str(eqs.front()) == "-x <= 0");
+        REQUIRE(str(eqs.inequality(0)) == "-x <= 0");
     }
 
     SECTION("example 3") {
@@ -38,7 +38,67 @@ TEST_CASE("parsing") {
 
         auto eqs = evaluate_theory(ctl.theory_atoms());
         REQUIRE(eqs.size() == 1);
-        REQUIRE(str(eqs.front()) == "-x + 2/3*y = -1");
+        REQUIRE(str(eqs.inequality(0)) == "-x + 2/3*y = -1");
+    }
+
+    SECTION("combine") {
+        ctl.add("base", {}, "&sum {  x; 2*x; y; -y; 3/\"1234567890123\"*z } >= \"12345678901\".\n");
+        ctl.ground({{"base", {}}});
+
+        auto eqs = evaluate_theory(ctl.theory_atoms());
+        REQUIRE(eqs.size() == 1);
+        REQUIRE(eqs.num_vars() == 3);
+        REQUIRE(str(eqs.inequality(0)) == "3*x + 3/1234567890123*z >= 12345678901");
+        REQUIRE(eqs.begin(0)->co.is_inline());
+        REQUIRE(!(eqs.begin(0) + 1)->co.is_inline());
+        REQUIRE(!eqs.rhs(0).is_inline());
+    }
+
+    SECTION("decimals") {
+        ctl.add("base", {}, "&sum {  \"0.750\"*x; \"-1.5\"*y; \"2.0\"*z } <= \"10.25\".\n");
+        ctl.ground({{"base", {}}});
+
+        auto eqs = evaluate_theory(ctl.theory_atoms());
+        REQUIRE(eqs.size() == 1);
+        REQUIRE(str(eqs.inequality(0)) == "3/4*x + -3/2*y + 2*z <= 41/4");
+    }
+
+    SECTION("invalid decimal") {
+        ctl.add("base", {}, "&sum {  \"1.\"*x } <= 0.\n");
+        ctl.ground({{"base", {}}});
+
+        REQUIRE_THROWS(evaluate_theory(ctl.theory_atoms()));
+    }
+
+    SECTION("threads") {
+        ctl.add("base", {}, "{ c(1..3000) }.\n"
+                            "&sum { x(I); y(J) : c(J), J=I-1..I+1 } >= I :- I=1..3000.\n"
+                            "&dom { 0..I } = z(I) :- I=1..3000.\n");
+        ctl.ground({{"base", {}}});
+
+        auto seq = evaluate_theory(ctl.theory_atoms());
+        auto par = evaluate_theory(ctl.theory_atoms(), 4);
+        REQUIRE(seq.size() == par.size());
+        for (size_t i = 0; i < seq.size(); ++i) {
+            REQUIRE(str(seq.inequality(i)) == str(par.inequality(i)));
+        }
+    }
+
+    SECTION("offset") {
+        ctl.add("base", {}, "{ c }.\n"
+                            "&sum { x : c } >= 1.\n"
+                            "&sum { x : c; y } >= 2.\n");
+        ctl.ground({{"base", {}}});
+
+        AuxMap aux;
+        auto all = evaluate_theory(ctl.theory_atoms());
+        auto first = evaluate_theory(ctl.theory_atoms(), 1, 0, aux);
+        auto second = evaluate_theory(ctl.theory_atoms(), 1, ctl.theory_atoms().size() - 1, aux);
+        // the auxiliary variable of the first atom is reused by the second one
+        REQUIRE(aux.size() == 1);
+        REQUIRE(first.size() == all.size());
+        REQUIRE(second.size() == 1);
+        REQUIRE(str(second.inequality(0)) == str(all.inequality(all.size() - 1)));
     }
 };
 
@@ -0,0 +1,45 @@
+#include <pool.hh>
+
+#include <catch.hpp>
+#include <stdexcept>
+
+TEST_CASE("pool") {
+    SECTION("run") {
+        WorkerPool pool{3};
+        for (size_t n : {0, 1, 2, 100}) {
+            std::vector<size_t> values(n, 0);
+            pool.run(n, [&values](size_t i) { values[i] += i + 1; });
+            for (size_t i = 0; i != n; ++i) {
+                REQUIRE(values[i] == i + 1);
+            }
+        }
+    }
+
+    SECTION("no workers") {
+        WorkerPool pool{0};
+        std::vector<size_t> values(10, 0);
+        pool.run(values.size(), [&values](size_t i) { values[i] = i; });
+        for (size_t i = 0; i != values.size(); ++i) {
+            REQUIRE(values[i] == i);
+        }
+    }
+
+    SECTION("exception") {
+        WorkerPool pool{2};
+        std::vector<size_t> values(10, 0);
+        REQUIRE_THROWS_AS(pool.run(values.size(), [&values](size_t i) {
+            if (i == 5) {
+                throw std::runtime_error("error");
+            }
+            values[i] = 1;
+        }), std::runtime_error);
+        size_t n = 0;
+        for (auto value : values) {
+            n += value;
+        }
+        REQUIRE(n == 9);
+        // the pool is still usable after an exception
+        pool.run(values.size(), [&values](size_t i) { values[i] = 2; });
+        REQUIRE(values == std::vector<size_t>(10, 2));
+    }
+}
@@ -0,0 +1,30 @@
+#include <problem.hh>
+
+#include <catch.hpp>
+
+TEST_CASE("problem") {
+    SECTION("bandwidth order") {
+        Problem problem;
+        auto a = problem.add_var(Clingo::Function("a", {}));
+        auto b = problem.add_var(Clingo::Function("b", {}));
+        auto c = problem.add_var(Clingo::Function("c", {}));
+        auto d = problem.add_var(Clingo::Function("d", {}));
+        auto e = problem.add_var(Clingo::Function("e", {}));
+        auto add_row = [&problem](uint32_t x, uint32_t y, Clingo::literal_t lit) {
+            problem.add_term(Number{1}, x);
+            problem.add_term(Number{1}, y);
+            problem.add_row(Number{0}, Relation::LessEqual, lit);
+        };
+        // the rows form the chain a - b - c - d
+        add_row(a, b, 1);
+        add_row(c, d, 2);
+        add_row(b, c, 3);
+        // a separate component
+        problem.add_term(Number{1}, e);
+        problem.add_row(Number{0}, Relation::LessEqual, 4);
+        // each component is traversed starting from a row of minimum degree
+        // and the order is reversed
+        REQUIRE(problem.bandwidth_order() == std::vector<size_t>{1, 2, 0, 3});
+        REQUIRE(Problem{}.bandwidth_order().empty());
+    }
+}
@@ -0,0 +1,138 @@
+#include <reading.hh>
+
+#include <catch.hpp>
+#include <sstream>
+
+namespace {
+
+template <typename T>
+std::string str(T &&x) {
+    std::ostringstream oss;
+    oss << x;
+    return oss.str();
+}
+
+//! Return the rows of a problem with their literals.
+std::vector<std::string> rows(Problem const &problem) {
+    std::vector<std::string> ret;
+    for (size_t i = 0; i < problem.size(); ++i) {
+        ret.emplace_back(str(problem.lit(i)) + ": " + str(problem.inequality(i)));
+    }
+    return ret;
+}
+
+//! Guard rows by literals numbered in order of their first occurrence and
+//! bounds by literal 1.
+class Guards {
+public:
+    Clingo::literal_t operator()(char const *name) {
+        if (name == nullptr) {
+            return 1;
+        }
+        names_.emplace_back(name);
+        return static_cast<Clingo::literal_t>(names_.size() + 1);
+    }
+
+    [[nodiscard]] std::vector<std::string> const &names() const {
+        return names_;
+    }
+
+private:
+    std::vector<std::string> names_;
+};
+
+} // namespace
+
+TEST_CASE("reading") {
+    Guards guards;
+    Guard guard = [&guards](char const *name) { return guards(name); };
+
+    SECTION("lp") {
+        std::istringstream in{
+            "\\ an example\n"
+            "Maximize\n"
+            " obj: x + 2 y\n"
+            "Subject To\n"
+            " c1: x + y\n"
+            "     <= 4.5\n"
+            " -x + 3y >= -2 2x - y =< 1e1\n"
+            "Bounds\n"
+            " -inf <= x <= 3\n"
+            " y free\n"
+            " 0.25 <= Z\n"
+            "Binary\n"
+            " b\n"
+            "End\n"};
+        auto problem = read_lp(in, guard);
+        REQUIRE(guards.names() == std::vector<std::string>{"c1", "c2", "c3"});
+        REQUIRE(rows(problem) == std::vector<std::string>{
+            "2: x + y <= 9/2",
+            "3: -x + 3*y >= -2",
+            "4: 2*x + -y <= 10",
+            "1: x <= 3",
+            "1: \"Z\" >= 1/4",
+            "1: b >= 0",
+            "1: b <= 1"});
+    }
+
+    SECTION("lp fractions") {
+        std::istringstream in{"Subject To\n 1/3 x - 2/4 y >= 1.5e-1/3\nBounds\n x free\n y free\nEnd\n"};
+        auto problem = read_lp(in, guard);
+        REQUIRE(rows(problem) == std::vector<std::string>{"2: 1/3*x + -1/2*y >= 1/20"});
+    }
+
+    SECTION("lp errors") {
+        std::istringstream missing{"Subject To\n x + y >=\n"};
+        REQUIRE_THROWS(read_lp(missing, guard));
+        std::istringstream number{"Subject To\n x + y >= 1.2.3\n"};
+        REQUIRE_THROWS(read_lp(number, guard));
+        std::istringstream section{"x + y >= 1\n"};
+        REQUIRE_THROWS(read_lp(section, guard));
+    }
+
+    SECTION("mps") {
+        std::istringstream in{
+            "NAME example\n"
+            "ROWS\n"
+            " N obj\n"
+            " L r1\n"
+            " G r2\n"
+            " E r3\n"
+            "COLUMNS\n"
+            " x obj 1 r1 1\n"
+            " x r2 1\n"
+            " y r1 1 r3 -0.5\n"
+            "RHS\n"
+            " rhs r1 4 r2 1\n"
+            " rhs r3 2\n"
+            "RANGES\n"
+            " rng r1 2\n"
+            "BOUNDS\n"
+            " UP bnd x 3\n"
+            " FR bnd y\n"
+            "ENDATA\n"};
+        auto problem = read_mps(in, guard);
+        REQUIRE(guards.names() == std::vector<std::string>{"r1", "r2", "r3"});
+        REQUIRE(rows(problem) == std::vector<std::string>{
+            "2: x + y >= 2",
+            "2: x + y <= 4",
+            "3: x >= 1",
+            "4: -1/2*y = 2",
+            "1: x >= 0",
+            "1: x <= 3"});
+    }
+
+    SECTION("mps errors") {
+        std::istringstream row{"ROWS\n L r1\nCOLUMNS\n x r2 1\nENDATA\n"};
+        REQUIRE_THROWS(read_mps(row, guard));
+        std::istringstream bound{"ROWS\n L r1\nBOUNDS\n XX bnd x 1\nENDATA\n"};
+        REQUIRE_THROWS(read_mps(bound, guard));
+    }
+
+    SECTION("basis") {
+        std::istringstream in{"NAME clingo-lpx\n XL x r0\n XU _s1 r1\n LL y\n BS z\nENDATA\n"};
+        REQUIRE(read_basis(in) == std::vector<std::string>{"x", "_s1", "z"});
+        std::istringstream indicator{"NAME clingo-lpx\n XX x r0\nENDATA\n"};
+        REQUIRE_THROWS(read_basis(indicator));
+    }
+}
@@ -0,0 +1,43 @@
+#include <snapshot.hh>
+
+#include <catch.hpp>
+#include <sstream>
+
+TEST_CASE("snapshot") {
+    std::ostringstream oss;
+    SnapshotWriter out{oss};
+    out.write_u32(42);
+    out.write_i32(-7);
+    out.write_string("x(1)");
+    out.write_number(Number{"-123456789012345678901234567890/7"});
+    out.write_number(0);
+    auto data = oss.str();
+
+    SECTION("read") {
+        SnapshotReader in{data.data(), data.size()};
+        auto size = in.remaining();
+        REQUIRE(in.read_u32() == 42);
+        REQUIRE(in.remaining() == size - 4);
+        REQUIRE(in.read_i32() == -7);
+        REQUIRE(in.read_string() == "x(1)");
+        REQUIRE(in.read_number() == Number{"-123456789012345678901234567890/7"});
+        REQUIRE(in.read_number() == 0);
+        REQUIRE(in.remaining() == 0);
+        REQUIRE_THROWS(in.read_u32());
+    }
+
+    SECTION("truncated") {
+        SnapshotReader in{data.data(), data.size() - 1};
+        REQUIRE(in.read_u32() == 42);
+        REQUIRE(in.read_i32() == -7);
+        REQUIRE(in.read_string() == "x(1)");
+        REQUIRE(in.read_number() == Number{"-123456789012345678901234567890/7"});
+        REQUIRE_THROWS(in.read_number());
+    }
+
+    SECTION("header") {
+        REQUIRE_THROWS(SnapshotReader{data.data(), 4});
+        data[0] = 'X';
+        REQUIRE_THROWS(SnapshotReader{data.data(), data.size()});
+    }
+}
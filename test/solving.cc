@@ -1,7 +1,13 @@
 #include <parsing.hh>
+#include <reading.hh>
 #include <solving.hh>
 
+#include <algorithm>
 #include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 namespace {
 
@@ -27,6 +33,70 @@ bool run_q(char const *s) {
     return ctl.solve(Clingo::LiteralSpan{}, nullptr, false, false).get().is_satisfiable();
 }
 
+//! Ground and solve the given programs one after another checking that each
+//! step is satisfiable if and only if this is expected.
+void run_steps(std::vector<std::pair<char const *, bool>> const &steps, Options const &options = Options{}) {
+    Propagator<Number, Number> prp{options};
+    Clingo::Control ctl;
+    prp.register_control(ctl);
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        auto name = "step" + std::to_string(i);
+        ctl.add(name.c_str(), {}, steps[i].first);
+        ctl.ground({{name.c_str(), {}}});
+        REQUIRE(ctl.solve(Clingo::LiteralSpan{}, nullptr, false, false).get().is_satisfiable() == steps[i].second);
+    }
+}
+
+//! Solve the given program and return the prepared problem in LP format
+//! together with the final basis.
+std::pair<std::string, std::string> write(char const *s, Options const &options = Options{}) {
+    Propagator<Number, Number> prp{options};
+    Clingo::Control ctl;
+    prp.register_control(ctl);
+
+    ctl.add("base", {}, s);
+    ctl.ground({{"base", {}}});
+    static_cast<void>(ctl.solve(Clingo::LiteralSpan{}, nullptr, false, false).get());
+
+    std::ostringstream problem;
+    std::ostringstream basis;
+    prp.write_problem(problem, false);
+    prp.write_basis(basis);
+    return {problem.str(), basis.str()};
+}
+
+//! Collect the theory symbols added to models by the propagator.
+template <class Value>
+class ModelHandler : public Clingo::SolveEventHandler {
+public:
+    explicit ModelHandler(Propagator<Number, Value> &prp)
+    : prp_{prp} { }
+
+    bool on_model(Clingo::Model &model) override {
+        prp_.extend_model(model);
+        std::vector<std::string> current;
+        for (auto const &sym : model.symbols(Clingo::ShowType::Atoms)) {
+            current.emplace_back(sym.to_string());
+        }
+        for (auto const &sym : model.symbols(Clingo::ShowType::Theory)) {
+            symbols.emplace_back(sym.to_string());
+            current.emplace_back(sym.to_string());
+        }
+        std::sort(current.begin(), current.end());
+        models.emplace_back(std::move(current));
+        return true;
+    }
+
+    //! The theory symbols of all models.
+    std::vector<std::string> symbols;
+    //! The sorted atoms and theory symbols of each model.
+    std::vector<std::vector<std::string>> models;
+
+private:
+    Propagator<Number, Value> &prp_;
+};
+
 } // namespace
 
 TEST_CASE("solving") {
@@ -78,5 +148,320 @@ TEST_CASE("solving") {
                        "&sum { y; -z } > 0.\n"
                        "&sum { z; -x } > 0.\n"));
     }
+    SECTION("constant rows") {
+        // rows whose terms cancel are checked against zero
+        REQUIRE( run("&sum { x; -x } <= 1.\n"));
+        REQUIRE( run("&sum { x; -x } = 0.\n"));
+        REQUIRE(!run("&sum { x; -x } >= 1.\n"));
+        REQUIRE(!run("&sum { x; -x } = 1.\n"));
+        REQUIRE( run("{ a }. &sum { x; -x } >= 1 :- a.\n"));
+        REQUIRE(!run("{ a }. &sum { x; -x } >= 1 :- a. :- not a.\n"));
+
+        REQUIRE( run_q("&sum { x; -x } < 1.\n"));
+        REQUIRE(!run_q("&sum { x; -x } < 0.\n"));
+        REQUIRE( run_q("&sum { x; -x } > -1.\n"));
+        REQUIRE(!run_q("&sum { x; -x } > 0.\n"));
+    }
+    SECTION("difference logic") {
+        REQUIRE(!run("&sum { x; -y } <= -1.\n"
+                     "&sum { y; -z } <= -1.\n"
+                     "&sum { 2*z; -2*x } <= -2.\n"));
+
+        REQUIRE( run("&sum { x; -y } >= 1.\n"
+                     "&sum { y; -z } >= 1.\n"
+                     "&sum { z } >= 0.\n"
+                     "&sum { x } <= 2.\n"));
+
+        REQUIRE(!run("&sum { x; -y } >= 1.\n"
+                     "&sum { y; -z } >= 1.\n"
+                     "&sum { z } >= 0.\n"
+                     "&sum { x } <= 1.\n"));
+
+        // the difference constraints interact with a general row
+        REQUIRE(!run("&sum { x; -y } >= 1.\n"
+                     "&sum { u; -v } = 0.\n"
+                     "&sum { x; y; u } <= 0.\n"
+                     "&sum { y } >= 0.\n"
+                     "&sum { v } >= 0.\n"));
+
+        REQUIRE(!run_q("{ a }.\n"
+                       "&sum { x; -y } > 0.\n"
+                       "&sum { y; -x } >= 0 :- a.\n"
+                       ":- not a.\n"));
+    }
+    SECTION("export") {
+        auto [problem, basis] = write("&sum { x; 2*y } >= 1.\n"
+                                      "&sum { \"1.5\"*x } <= 3.\n"
+                                      "&sum { \"0.5\"*x; \"-0.75\"*y } <= 1.\n"
+                                      "&sum { 2*z } <= 1.\n");
+        // the rows are ordered before preparing the tableau and the names of
+        // the auxiliary variables are looked up
+        auto slack = [&problem = problem](std::string const &terms) {
+            auto pos = problem.find(terms);
+            REQUIRE(pos != std::string::npos);
+            pos += terms.size();
+            return problem.substr(pos, problem.find(' ', pos) - pos);
+        };
+        auto s0 = slack(": x + 2 y - ");
+        REQUIRE(problem.find(": " + s0 + " >= 1\n") != std::string::npos);
+        REQUIRE(problem.find(" " + s0 + " free\n") != std::string::npos);
+        // rows are scaled to integral coefficients
+        auto s1 = slack(": 2 x - 3 y - ");
+        REQUIRE(problem.find(": " + s1 + " <= 4\n") != std::string::npos);
+        REQUIRE(problem.find(": x <= 2\n") != std::string::npos);
+        // fractional bounds are scaled to integers, too
+        REQUIRE(problem.find(": 2 z <= 1\n") != std::string::npos);
+        REQUIRE(problem.find('/') == std::string::npos);
+        REQUIRE(basis.rfind("NAME", 0) == 0);
+        REQUIRE(basis.find(" r0\n") != std::string::npos);
+        // auxiliary variables are named after the terms of their rows
+        auto shifted = write("&sum { x; 3*y } >= 1.\n"
+                             "&sum { x; 2*y } >= 1.\n").first;
+        REQUIRE(shifted.find(": x + 2 y - " + s0 + " = 0\n") != std::string::npos);
+    }
+
+    SECTION("multi-shot") {
+        run_steps({{"&sum { x; y } >= 2.\n", true},
+                   {"&sum { x } <= 1. &sum { y } <= 1.\n", true},
+                   {"&sum { x; -y } >= 1.\n", false}});
+    }
+
+    SECTION("components") {
+        REQUIRE( run("{ a }.\n"
+                     "&sum { x; 2*y } >= 2.\n"
+                     "&sum { u; 2*v } >= 2 :- a.\n"
+                     "&sum { u; v } <= 0 :- a.\n"
+                     "&sum { u } >= 0.\n"
+                     "&sum { v } <= 0.\n"));
+
+        run_steps({{"&sum { x; 2*y } >= 2. &sum { u; 2*v } <= 1. &sum { y } <= 0.\n", true},
+                   // the components are merged
+                   {"&sum { x; u } = 0.\n", true},
+                   {"&sum { u } >= 0.\n", false}});
+    }
+
+    SECTION("component assignment") {
+        Propagator<Number, Number> prp;
+        Clingo::Control ctl;
+        prp.register_control(ctl);
+        ctl.add("base", {}, "&sum { z; b } >= 2. &sum { a; y } >= 1. &sum { c; x } <= 3.\n");
+        ctl.ground({{"base", {}}});
+        REQUIRE(ctl.solve(Clingo::LiteralSpan{}, nullptr, false, false).get().is_satisfiable());
+        // the variables of all components are traversed in order
+        std::vector<std::string> vars;
+        prp.assignment(0, [&vars](Clingo::Symbol var, Number const &) {
+            vars.emplace_back(var.to_string());
+        });
+        REQUIRE(vars == std::vector<std::string>{"a", "b", "c", "x", "y", "z"});
+    }
+
+    SECTION("parallel components") {
+        Options options;
+        options.propagate_threads = 2;
+        auto solve = [&options](char const *s) {
+            Propagator<Number, Number> prp{options};
+            Clingo::Control ctl;
+            prp.register_control(ctl);
+            ctl.add("base", {}, s);
+            ctl.ground({{"base", {}}});
+            return ctl.solve(Clingo::LiteralSpan{}, nullptr, false, false).get().is_satisfiable();
+        };
+        char const *prg = "{ a; b; c }.\n"
+                          "&sum { x; 2*y } >= 2 :- a.\n"
+                          "&sum { x; y } <= 0.\n"
+                          "&sum { y } <= 0.\n"
+                          "&sum { u; 2*v } >= 2 :- b.\n"
+                          "&sum { u; v } <= 0.\n"
+                          "&sum { v } <= 0.\n"
+                          "&sum { s; 2*t } >= 2 :- c.\n"
+                          "&sum { s; t } <= 1.\n";
+        REQUIRE( solve(prg));
+        REQUIRE( solve((std::string{prg} + ":- not c.\n").c_str()));
+        REQUIRE(!solve((std::string{prg} + ":- not a.\n").c_str()));
+        REQUIRE(!solve((std::string{prg} + ":- not a. :- not b.\n").c_str()));
+    }
+
+    SECTION("equality bounds") {
+        // an equality bound tightening both bounds of a variable records
+        // both old bounds, which are restored when backtracking
+        Options options;
+        options.difference_logic = false;
+        Propagator<Number, Number> prp{options};
+        Clingo::Control ctl;
+        prp.register_control(ctl);
+        ctl.add("base", {}, "{ a; b }.\n"
+                            "&sum { x } >= 0.\n"
+                            "&sum { x } = 3 :- a.\n"
+                            "&sum { x } <= -1 :- b.\n");
+        ctl.ground({{"base", {}}});
+        auto solve = [&ctl](char const *name, bool sign) {
+            auto lit = ctl.symbolic_atoms().find(Clingo::Function(name, {}))->literal();
+            if (!sign) {
+                lit = -lit;
+            }
+            return ctl.solve(Clingo::LiteralSpan{&lit, 1}, nullptr, false, false).get().is_satisfiable();
+        };
+        REQUIRE( solve("a", true));
+        REQUIRE(!solve("b", true));
+        REQUIRE( solve("b", false));
+    }
+
+    SECTION("multi-shot difference logic") {
+        run_steps({{"&sum { x; -y } >= 1. &sum { y } >= 0.\n", true},
+                   // the variables of the difference logic engine move to
+                   // the tableau
+                   {"&sum { x; y } <= 2.\n", true},
+                   {"&sum { y } >= 1.\n", false}});
+    }
+
+    SECTION("show values") {
+        Options options;
+        REQUIRE(parse_show_values("x/0,p/1", options));
+        REQUIRE(!parse_show_values("p", options));
+        REQUIRE(!parse_show_values("p/x", options));
+        Propagator<Number, NumberQ> prp{options};
+        Clingo::Control ctl;
+        prp.register_control(ctl);
+        ModelHandler<NumberQ> handler{prp};
+
+        ctl.add("base", {}, "&sum { x } = 3. &sum { 2*p(1) } = 1. &sum { p(1); -y } > 0.\n");
+        ctl.ground({{"base", {}}});
+        REQUIRE(ctl.solve(Clingo::LiteralSpan{}, &handler, false, false).get().is_satisfiable());
+        std::sort(handler.symbols.begin(), handler.symbols.end());
+        REQUIRE(handler.symbols == std::vector<std::string>{"lpx(p(1),\"1/2\")", "lpx(x,3)"});
+    }
+
+    SECTION("inactive rows") {
+        Options options;
+        options.show_values = true;
+        Propagator<Number, Number> prp{options};
+        Clingo::Control ctl;
+        prp.register_control(ctl);
+        ModelHandler<Number> handler{prp};
+
+        // the rows guarded by a and b are only updated once they are active
+        ctl.add("base", {}, "{ a; b }. :- not a. :- not b.\n"
+                            "&sum { x; y } >= 2 :- a. &sum { x; -y } >= 0 :- b.\n"
+                            "&sum { x } <= 1. &sum { y } <= 1.\n");
+        ctl.ground({{"base", {}}});
+        REQUIRE(ctl.solve(Clingo::LiteralSpan{}, &handler, false, false).get().is_satisfiable());
+        std::sort(handler.symbols.begin(), handler.symbols.end());
+        REQUIRE(handler.symbols == std::vector<std::string>{"lpx(x,1)", "lpx(y,1)"});
+    }
+
+    SECTION("inactive rows with backtracking") {
+        // a and b are decided above the top level so that the guarded rows
+        // are activated lazily and deactivated again when backtracking; in
+        // the second program the auxiliary variables s and t turn the
+        // guarded rows into bounds, which bypasses inactive rows
+        char const *rows = "&sum { x; y } = 2 :- a. &sum { x; y } = 0 :- not a.\n"
+                           "&sum { x; -y } = 2 :- b. &sum { x; -y } = 0 :- not b.\n";
+        char const *bounds = "&sum { x; y; -s } = 0. &sum { x; -y; -t } = 0.\n"
+                             "&sum { s } = 2 :- a. &sum { s } = 0 :- not a.\n"
+                             "&sum { t } = 2 :- b. &sum { t } = 0 :- not b.\n";
+        std::vector<std::vector<std::vector<std::string>>> results;
+        for (auto const *prg : {rows, bounds}) {
+            Options options;
+            REQUIRE(parse_show_values("x/0,y/0", options));
+            Propagator<Number, Number> prp{options};
+            Clingo::Control ctl{{"0"}};
+            prp.register_control(ctl);
+            ModelHandler<Number> handler{prp};
+            ctl.add("base", {}, "{ a; b }.\n");
+            ctl.add("base", {}, prg);
+            ctl.ground({{"base", {}}});
+            REQUIRE(ctl.solve(Clingo::LiteralSpan{}, &handler, false, false).get().is_satisfiable());
+            std::sort(handler.models.begin(), handler.models.end());
+            results.emplace_back(std::move(handler.models));
+        }
+        REQUIRE(results[0] == std::vector<std::vector<std::string>>{
+            {"a", "b", "lpx(x,2)", "lpx(y,0)"},
+            {"a", "lpx(x,1)", "lpx(y,1)"},
+            {"b", "lpx(x,1)", "lpx(y,-1)"},
+            {"lpx(x,0)", "lpx(y,0)"}});
+        REQUIRE(results[0] == results[1]);
+    }
+
+    SECTION("simplify") {
+        // x is fixed on the top level and its column removed
+        char const *prg = "{ a; b }.\n"
+                          "&sum { x } >= 1. &sum { x } <= 1.\n"
+                          "&sum { x; y } >= 3 :- a. &sum { x; y; z } <= 2 :- b.\n"
+                          "&sum { y; -z } <= 1.\n";
+        std::vector<std::vector<std::string>> results;
+        for (bool simplify : {true, false}) {
+            Options options;
+            options.show_values = true;
+            options.simplify = simplify;
+            Propagator<Number, Number> prp{options};
+            Clingo::Control ctl{{"0"}};
+            prp.register_control(ctl);
+            ModelHandler<Number> handler{prp};
+            ctl.add("base", {}, prg);
+            ctl.ground({{"base", {}}});
+            REQUIRE(ctl.solve(Clingo::LiteralSpan{}, &handler, false, false).get().is_satisfiable());
+            REQUIRE(std::count(handler.symbols.begin(), handler.symbols.end(), "lpx(x,1)") == 3);
+            std::sort(handler.symbols.begin(), handler.symbols.end());
+            results.emplace_back(std::move(handler.symbols));
+        }
+        REQUIRE(results[0] == results[1]);
+    }
+
+    SECTION("multi-shot simplify") {
+        // x is fixed on the top level in the first step and its column
+        // removed before the later steps mention it again
+        run_steps({{"&sum { x } >= 1. &sum { x } <= 1. &sum { x; y } <= 5.\n", true},
+                   {"&sum { x; 2*z } >= 3. &sum { x; -2*y } >= 0.\n", true},
+                   {"&sum { z } <= 0.\n", false}});
+    }
+
+    SECTION("multi-shot snapshot") {
+        char const *base = "{ a }. &sum { x : a } >= 1.\n";
+        Options options;
+        options.save_snapshot = "multi_shot.snap";
+        run_steps({{base, true}}, options);
+        options.load_snapshot = options.save_snapshot;
+        options.save_snapshot.clear();
+        run_steps({{base, true},
+                   // the conditional term of the new step must not share the
+                   // auxiliary variable of the conditional term in the
+                   // snapshot
+                   {"{ b }. &sum { y : b } <= 0. :- not b.\n", true}},
+                  options);
+        std::remove(options.load_snapshot.c_str());
+    }
+
+    SECTION("warm start") {
+        // solving the first program pivots x and y into the basis while the
+        // zero assignment already satisfies the second one
+        char const *prg = "&sum { x; 2*y } >= 1.\n"
+                          "&sum { x; -y } <= 0.\n"
+                          "&sum { \"1.5\"*x } <= 3.\n";
+        char const *feasible = "&sum { x; 2*y } >= -1.\n"
+                               "&sum { x; -y } <= 0.\n"
+                               "&sum { \"1.5\"*x } <= 3.\n";
+        auto basic_vars = [](std::string const &basis) {
+            std::istringstream in{basis};
+            auto vars = read_basis(in);
+            std::sort(vars.begin(), vars.end());
+            return vars;
+        };
+        auto [problem, basis] = write(prg);
+        auto [cold_problem, cold_basis] = write(feasible);
+        REQUIRE(basic_vars(basis) == std::vector<std::string>{"x", "y"});
+        REQUIRE(basic_vars(cold_basis) != basic_vars(basis));
+
+        // unknown names are ignored
+        Options options;
+        options.load_basis = "warm_start.bas";
+        {
+            std::ofstream out{options.load_basis};
+            out << basis.substr(0, basis.rfind("ENDATA")) << " XL unknown r7\n" << "ENDATA\n";
+        }
+        auto [warm_problem, warm_basis] = write(feasible, options);
+        std::remove(options.load_basis.c_str());
+        REQUIRE(warm_problem == cold_problem);
+        REQUIRE(basic_vars(warm_basis) == basic_vars(basis));
+    }
 };
 
@@ -46,6 +46,88 @@ TEST_CASE("util") {
         // traverse the first column
         t.update_col(0, [](index_t j, Number &a) { });
         REQUIRE(t.size() == 1);
+
+        // memory includes the limbs of the values
+        auto bytes = t.bytes();
+        REQUIRE(bytes > 0);
+        t.set(0, 2, Number{"123456789012345678901234567890/7"});
+        REQUIRE(t.bytes() > bytes);
+        REQUIRE(dynamic_bytes(t.get(0, 2)) > 0);
+
+        // clear rows and columns
+        t.set(0, 1, 4);
+        t.set(1, 1, 5);
+        t.set(1, 2, 6);
+        REQUIRE(t.size() == 4);
+        t.clear_col(2);
+        REQUIRE(t.size() == 2);
+        REQUIRE(t.get(0, 2) == 0);
+        t.clear_row(1);
+        t.shrink();
+        REQUIRE(t.size() == 1);
+        REQUIRE(t.get(0, 1) == 4);
+        size_t n = 0;
+        t.update_col(1, [&n](index_t i, Number &a) {
+            REQUIRE(i == 0);
+            ++n;
+        });
+        REQUIRE(n == 1);
+    }
+
+    SECTION("index set") {
+        IndexSet s;
+        s.resize(200);
+        REQUIRE(s.empty());
+
+        // the smallest index is returned first
+        s.insert(130);
+        s.insert(7);
+        s.insert(64);
+        s.insert(7);
+        REQUIRE(!s.empty());
+        REQUIRE(s.contains(64));
+        REQUIRE(!s.contains(65));
+        REQUIRE(s.min() == 7);
+        s.erase(7);
+        REQUIRE(!s.contains(7));
+        REQUIRE(s.min() == 64);
+        s.erase(64);
+        REQUIRE(s.min() == 130);
+
+        // smaller indices can be inserted after retrieving larger ones
+        s.insert(3);
+        REQUIRE(s.min() == 3);
+        s.erase(3);
+        s.erase(130);
+        REQUIRE(s.empty());
+
+        // clearing removes all indices
+        s.insert(199);
+        s.insert(0);
+        s.clear();
+        REQUIRE(s.empty());
+        REQUIRE(!s.contains(0));
+        REQUIRE(!s.contains(199));
+        s.resize(5000);
+        s.insert(4096);
+        REQUIRE(s.min() == 4096);
+
+        // repeatedly inserting and erasing indices keeps the set intact
+        s.insert(4000);
+        for (index_t i = 0; i != 10000; ++i) {
+            s.insert(i % 300);
+            s.insert(4500);
+            REQUIRE(s.min() == i % 300);
+            s.erase(i % 300);
+            s.erase(4500);
+        }
+        REQUIRE(s.min() == 4000);
+        s.clear();
+        REQUIRE(s.empty());
+        REQUIRE(!s.contains(4000));
+        REQUIRE(!s.contains(4096));
+        s.insert(4999);
+        REQUIRE(s.min() == 4999);
     }
 
     SECTION("strict") {
@@ -76,4 +158,39 @@ TEST_CASE("util") {
         REQUIRE((a *= c) == NumberQ{12, 9});
         REQUIRE((a /= c) == NumberQ{4, 3});
     }
+
+    SECTION("strict comparison") {
+        Number c{3};
+
+        // the rational components are compared first
+        REQUIRE(NumberQ{2, 1} < c);
+        REQUIRE(NumberQ{2, 1} <= c);
+        REQUIRE(!(NumberQ{2, 1} > c));
+        REQUIRE(!(NumberQ{2, 1} >= c));
+        REQUIRE(NumberQ{4, -1} > c);
+        REQUIRE(NumberQ{4, -1} >= c);
+        REQUIRE(!(NumberQ{4, -1} < c));
+        REQUIRE(!(NumberQ{4, -1} <= c));
+
+        // the infinitesimal components break ties
+        REQUIRE(NumberQ{3, -1} < c);
+        REQUIRE(!(NumberQ{3, -1} >= c));
+        REQUIRE(NumberQ{3, 1} > c);
+        REQUIRE(!(NumberQ{3, 1} <= c));
+        REQUIRE(NumberQ{3} <= c);
+        REQUIRE(NumberQ{3} >= c);
+        REQUIRE(NumberQ{3} == c);
+        REQUIRE(NumberQ{3, 1} != c);
+
+        // comparisons with numbers agree with comparisons with pairs
+        for (int i = 2; i <= 4; ++i) {
+            for (int k = -1; k <= 1; ++k) {
+                NumberQ q{i, k};
+                REQUIRE((q < c) == (q < NumberQ{c}));
+                REQUIRE((q <= c) == (q <= NumberQ{c}));
+                REQUIRE((q > c) == (q > NumberQ{c}));
+                REQUIRE((q >= c) == (q >= NumberQ{c}));
+            }
+        }
+    }
 };